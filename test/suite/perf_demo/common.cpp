@@ -20,6 +20,20 @@
 #include <flow/util/util.hpp>
 #include <flow/error/error.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <utility>
+#include <sys/resource.h>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#endif
 
 /* These programs are doing some things that are counter-indicated for production server
  * applications; namely it is enforced that it is invoked from the dir where both session-server and -client apps
@@ -32,11 +46,20 @@ const fs::path WORK_DIR = fs::canonical(fs::current_path().lexically_normal());
 // Has to match CMakeLists.txt-stored executable name.
 static const std::string S_EXEC_PREFIX = "perf_demo_";
 static const std::string S_EXEC_POSTFIX = ".exec";
-#if JEM_ELSE_CLASSIC
-static const std::string S_EXEC_PRE_POSTFIX = "_shm_jemalloc";
+static const std::string S_EXEC_PRE_POSTFIX =
+#if SHM_PROVIDER == SHM_PROVIDER_JEMALLOC
+  "_shm_jemalloc"
+#elif SHM_PROVIDER == SHM_PROVIDER_CLASSIC
+  "_shm_classic"
 #else
-static const std::string S_EXEC_PRE_POSTFIX = "_shm_classic";
+  "_heap"
+#endif
+#if MQ_TYPE == MQ_TYPE_POSIX
+  "_mq_posix"
+#elif MQ_TYPE == MQ_TYPE_BIPC
+  "_mq_bipc"
 #endif
+  ;
 const std::string SRV_NAME = "srv";
 const std::string CLI_NAME = "cli";
 
@@ -79,11 +102,491 @@ void ensure_run_env(const char* argv0, bool srv_else_cli)
   }
 }
 
+Serialize_via serialize_via(const Cmd_line& cmd_line)
+{
+  constexpr bool SHM_ENABLED = SHM_PROVIDER != SHM_PROVIDER_NONE;
+
+  const auto val = cmd_line.opt<std::string>("serialize", SHM_ENABLED ? "session-shm" : "heap");
+  if (SHM_ENABLED && (val == "session-shm"))
+  {
+    return Serialize_via::S_SESSION_SHM;
+  }
+  if (SHM_ENABLED && (val == "app-shm"))
+  {
+    return Serialize_via::S_APP_SHM;
+  }
+  if ((!SHM_ENABLED) && (val == "heap"))
+  {
+    return Serialize_via::S_HEAP;
+  }
+  // else
+  throw flow::error::Runtime_error
+          (flow::util::ostream_op_string("--serialize=[", val, "] is not available in this build; it supports: [",
+                                         SHM_ENABLED ? "session-shm, app-shm" : "heap", "]."));
+}
+
+std::string build_variant()
+{
+  return S_EXEC_PRE_POSTFIX.substr(1); // Sans the leading '_'.
+}
+
+std::string transport_desc()
+{
+#if MQ_TYPE == MQ_TYPE_POSIX
+  return "POSIX-MQ";
+#elif MQ_TYPE == MQ_TYPE_BIPC
+  return "bipc-MQ";
+#else
+  return "local-stream-socket";
+#endif
+}
+
+std::string serialize_desc(Serialize_via serialize_via)
+{
+  switch (serialize_via)
+  {
+  case Serialize_via::S_HEAP:
+    return "heap-backed (not zero-copy)";
+  case Serialize_via::S_SESSION_SHM:
+  case Serialize_via::S_APP_SHM:
+    return std::string(
+#if SHM_PROVIDER == SHM_PROVIDER_JEMALLOC
+             "SHM-jemalloc-backed"
+#else
+             "SHM-classic-backed"
+#endif
+             ) + ((serialize_via == Serialize_via::S_APP_SHM) ? ", app-scope" : ", session-scope");
+  }
+  assert(false);
+  return "";
+}
+
+std::string io_variant_desc(Io_variant variant)
+{
+  switch (variant)
+  {
+  case Io_variant::S_RAW_SYNC_IO:
+    return "raw Channel, sync_io";
+  case Io_variant::S_RAW_ASYNC_IO:
+    return "raw Channel, async-I/O";
+  case Io_variant::S_STRUC_SYNC_IO:
+    return "struc::Channel, sync_io";
+  case Io_variant::S_STRUC_ASYNC_IO:
+    return "struc::Channel, async-I/O";
+  }
+  assert(false);
+  return "";
+}
+
+bool ping_pong_sz_ok(size_t sz, bool struc_else_raw, [[maybe_unused]] size_t max_blob_sz)
+{
+  /* Raw: the blob is 1 message of the transport.  Structured, heap-backed: the serialization is (and, with
+   * Heap_fixed_builder, any leaf must fit into 1 message); so similarly, plus some slack for the capnp and
+   * struc::Channel overhead.  Structured, SHM-backed: just a SHM handle is transmitted; any size is fine. */
+  if (!struc_else_raw)
+  {
+    return sz <= max_blob_sz;
+  }
+  // else
+#if SHM_PROVIDER == SHM_PROVIDER_NONE
+  constexpr size_t STRUC_OVERHEAD_SLACK = 1024;
+  return (sz + STRUC_OVERHEAD_SLACK) <= max_blob_sz;
+#else
+  return true;
+#endif
+}
+
+Ctx_switches ctx_switches()
+{
+  return res_usage().m_ctx_switches;
+}
+
+Res_usage res_usage(bool with_shmem)
+{
+  using std::string;
+
+  /* For each of file `path`'s lines "<key>:<whitespace><number>..." (e.g., "syscr: 123") whose key is in `vals`:
+   * sets *vals[key] = <number>.  The others stay as they were.  (Not there, e.g., in some containers: then they all
+   * do.) */
+  const auto read_vals = [](const char* path, std::initializer_list<std::pair<const char*, uint64_t*>> vals)
+  {
+    std::ifstream is(path);
+    string line;
+    while (std::getline(is, line))
+    {
+      const auto colon = line.find(':');
+      if (colon == string::npos)
+      {
+        continue;
+      }
+      // else
+      for (const auto& key_and_val : vals)
+      {
+        if (line.compare(0, colon, key_and_val.first) == 0)
+        {
+          // (strtoull() skips leading whitespace.)
+          *key_and_val.second = std::strtoull(line.c_str() + colon + 1, nullptr, 10);
+          break;
+        }
+      }
+    }
+  };
+
+  ::rusage usage;
+  if (::getrusage(RUSAGE_SELF, &usage) == -1)
+  {
+    throw Runtime_error(Error_code(errno, boost::system::system_category()), "getrusage()");
+  }
+  // else
+
+  Res_usage res;
+  res.m_ctx_switches = { uint64_t(usage.ru_nvcsw), uint64_t(usage.ru_nivcsw) };
+  res.m_minor_faults = uint64_t(usage.ru_minflt);
+  res.m_major_faults = uint64_t(usage.ru_majflt);
+  res.m_peak_rss_kib = uint64_t(usage.ru_maxrss); // (Linux: in KiB.)
+
+  read_vals("/proc/self/io", { { "syscr", &res.m_read_syscalls }, { "syscw", &res.m_write_syscalls },
+                               { "rchar", &res.m_read_bytes }, { "wchar", &res.m_write_bytes } });
+  if (with_shmem)
+  {
+    read_vals("/proc/self/status", { { "RssShmem", &res.m_shmem_rss_kib } });
+  }
+  return res;
+} // res_usage()
+
+// operator-() sans the correction for snapshot_cost().
+static Res_usage raw_diff(const Res_usage& later, const Res_usage& earlier)
+{
+  auto diff = later;
+  diff.m_ctx_switches.m_voluntary -= earlier.m_ctx_switches.m_voluntary;
+  diff.m_ctx_switches.m_involuntary -= earlier.m_ctx_switches.m_involuntary;
+  diff.m_minor_faults -= earlier.m_minor_faults;
+  diff.m_major_faults -= earlier.m_major_faults;
+  diff.m_read_syscalls -= earlier.m_read_syscalls;
+  diff.m_write_syscalls -= earlier.m_write_syscalls;
+  diff.m_read_bytes -= earlier.m_read_bytes;
+  diff.m_write_bytes -= earlier.m_write_bytes;
+  return diff;
+}
+
+/* What a res_usage() snapshot itself adds to the /proc/self/io counters of the difference it begins: its own read()s
+ * of that file (after the values were taken; e.g., the one that hits EOF).  Constant; so we measure it once, with
+ * a pair of back-to-back snapshots; and operator-() takes it out. */
+static const Res_usage& snapshot_cost()
+{
+  static const Res_usage cost = []() -> Res_usage
+  {
+    res_usage(); // Warm up (e.g., the 1st open() of the file).
+    const auto start = res_usage();
+    return raw_diff(res_usage(), start);
+  }();
+  return cost;
+}
+
+Res_usage operator-(const Res_usage& later, const Res_usage& earlier)
+{
+  using std::min;
+
+  auto diff = raw_diff(later, earlier);
+  const auto& cost = snapshot_cost();
+  diff.m_read_syscalls -= min(diff.m_read_syscalls, cost.m_read_syscalls);
+  diff.m_write_syscalls -= min(diff.m_write_syscalls, cost.m_write_syscalls);
+  diff.m_read_bytes -= min(diff.m_read_bytes, cost.m_read_bytes);
+  diff.m_write_bytes -= min(diff.m_write_bytes, cost.m_write_bytes);
+  return diff;
+}
+
+Res_usage& operator+=(Res_usage& total, const Res_usage& diff)
+{
+  using std::max;
+
+  total.m_ctx_switches.m_voluntary += diff.m_ctx_switches.m_voluntary;
+  total.m_ctx_switches.m_involuntary += diff.m_ctx_switches.m_involuntary;
+  total.m_minor_faults += diff.m_minor_faults;
+  total.m_major_faults += diff.m_major_faults;
+  total.m_read_syscalls += diff.m_read_syscalls;
+  total.m_write_syscalls += diff.m_write_syscalls;
+  total.m_read_bytes += diff.m_read_bytes;
+  total.m_write_bytes += diff.m_write_bytes;
+  total.m_peak_rss_kib = max(total.m_peak_rss_kib, diff.m_peak_rss_kib);
+  total.m_shmem_rss_kib = max(total.m_shmem_rss_kib, diff.m_shmem_rss_kib);
+  return total;
+}
+
+std::string res_usage_desc(const Res_usage& diff, uint64_t n)
+{
+  const auto per = [&](uint64_t val) -> double { return double(val) / double(std::max(n, uint64_t(1))); };
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1)
+     << "csw vol/invol [" << per(diff.m_ctx_switches.m_voluntary) << '/' << per(diff.m_ctx_switches.m_involuntary)
+     << "]; faults minor/major [" << per(diff.m_minor_faults) << '/' << per(diff.m_major_faults)
+     << "]; read()s/write()s [" << per(diff.m_read_syscalls) << '/' << per(diff.m_write_syscalls)
+     << "]; read/written [" << (per(diff.m_read_bytes) / 1024) << '/' << (per(diff.m_write_bytes) / 1024) << " Ki]"
+     << "; peak RSS [" << (diff.m_peak_rss_kib / 1024) << " Mi]";
+  if (diff.m_shmem_rss_kib != 0)
+  {
+    os << "; SHM etc. resident [" << (diff.m_shmem_rss_kib / 1024) << " Mi]";
+  }
+  return os.str();
+}
+
+void run_event_loop(Task_engine* asio, flow::Fine_duration spin_budget, Busy_poll_stats* stats)
+{
+  using flow::Fine_clock;
+
+  if (spin_budget == flow::Fine_duration::zero())
+  {
+    asio->run();
+    return;
+  }
+  // else
+
+  // Like run(), this returns once the loop is stop()ped; or runs out of work (then poll()/run_one() stop() it).
+  while (!asio->stopped())
+  {
+    const auto spin_end = Fine_clock::now() + spin_budget;
+    bool hit = false;
+    do
+    {
+      if (asio->poll() != 0)
+      {
+        hit = true;
+        break;
+      }
+      // else
+#if defined(__x86_64__) || defined(__i386__)
+      _mm_pause(); // Be nice to a hyper-thread sibling.
+#elif defined(__aarch64__)
+      asm volatile("yield");
+#endif
+    }
+    while ((!asio->stopped()) && (Fine_clock::now() < spin_end));
+
+    if (hit)
+    {
+      ++stats->m_spin_hits;
+    }
+    else if (!asio->stopped())
+    {
+      ++stats->m_fallbacks;
+      asio->run_one();
+    }
+  }
+} // run_event_loop()
+
+Cmd_line::Cmd_line(int argc, char const * const * argv)
+{
+  using flow::util::String_view;
+
+  for (int idx = 0; idx != argc; ++idx)
+  {
+    const String_view arg(argv[idx]);
+    if ((idx == 0) || (arg.substr(0, 2) != "--"))
+    {
+      m_pos_args.emplace_back(arg);
+      continue;
+    }
+    // else
+
+    const auto eq_pos = arg.find('=');
+    if (eq_pos == String_view::npos)
+    {
+      m_opts[std::string(arg.substr(2))] = "1";
+    }
+    else
+    {
+      m_opts[std::string(arg.substr(2, eq_pos - 2))] = std::string(arg.substr(eq_pos + 1));
+    }
+  }
+}
+
+size_t Cmd_line::n_pos_args() const
+{
+  return m_pos_args.size();
+}
+
+const std::string& Cmd_line::pos_arg(size_t idx) const
+{
+  return m_pos_args[idx];
+}
+
+Histogram::Histogram() :
+  m_counts(S_N_SUB_BUCKETS + (64 - S_SUB_BUCKET_BITS) * S_N_SUB_BUCKETS, 0),
+  m_count(0),
+  m_min(0),
+  m_max(0),
+  m_mean(0),
+  m_m2(0)
+{
+  // That's it.
+}
+
+size_t Histogram::bucket_idx(uint64_t val)
+{
+  if (val < S_N_SUB_BUCKETS)
+  {
+    return size_t(val); // Exact.
+  }
+  // else: val is in [2^msb, 2^(msb + 1)); keep its top S_SUB_BUCKET_BITS + 1 bits (the top one being always 1).
+  const unsigned int msb = 63 - __builtin_clzll(val);
+  const auto shift = msb - S_SUB_BUCKET_BITS;
+  return size_t(S_N_SUB_BUCKETS + (shift * S_N_SUB_BUCKETS) + ((val >> shift) - S_N_SUB_BUCKETS));
+}
+
+uint64_t Histogram::bucket_highest_val(size_t idx)
+{
+  if (idx < S_N_SUB_BUCKETS)
+  {
+    return idx;
+  }
+  // else: Reverse of bucket_idx().
+  const auto shift = (idx - S_N_SUB_BUCKETS) / S_N_SUB_BUCKETS;
+  const auto top_bits = S_N_SUB_BUCKETS + ((idx - S_N_SUB_BUCKETS) % S_N_SUB_BUCKETS);
+  return ((top_bits + 1) << shift) - 1;
+}
+
+void Histogram::record(flow::Fine_duration sample)
+{
+  using boost::chrono::nanoseconds;
+  using boost::chrono::duration_cast;
+
+  const auto val = uint64_t(std::max(duration_cast<nanoseconds>(sample).count(), nanoseconds::rep(0)));
+
+  ++m_counts[bucket_idx(val)];
+  if ((m_count == 0) || (val < m_min))
+  {
+    m_min = val;
+  }
+  if ((m_count == 0) || (val > m_max))
+  {
+    m_max = val;
+  }
+
+  ++m_count;
+  const double delta = double(val) - m_mean;
+  m_mean += delta / double(m_count);
+  m_m2 += delta * (double(val) - m_mean);
+}
+
+void Histogram::merge(const Histogram& src)
+{
+  if (src.m_count == 0)
+  {
+    return;
+  }
+  // else
+
+  for (size_t idx = 0; idx != m_counts.size(); ++idx)
+  {
+    m_counts[idx] += src.m_counts[idx];
+  }
+  if ((m_count == 0) || (src.m_min < m_min))
+  {
+    m_min = src.m_min;
+  }
+  if ((m_count == 0) || (src.m_max > m_max))
+  {
+    m_max = src.m_max;
+  }
+
+  // Chan et al.'s pairwise combination of Welford's running values.
+  const auto count = m_count + src.m_count;
+  const double delta = src.m_mean - m_mean;
+  m_m2 += src.m_m2 + (delta * delta * double(m_count) * double(src.m_count) / double(count));
+  m_mean += delta * double(src.m_count) / double(count);
+  m_count = count;
+}
+
+void Histogram::save(std::ostream& os) const
+{
+  const auto write = [&](const auto& val) { os.write(reinterpret_cast<const char*>(&val), sizeof(val)); };
+
+  os.write(reinterpret_cast<const char*>(m_counts.data()), m_counts.size() * sizeof(uint64_t));
+  write(m_count);
+  write(m_min);
+  write(m_max);
+  write(m_mean);
+  write(m_m2);
+}
+
+void Histogram::load(std::istream& is)
+{
+  const auto read = [&](auto* val) { is.read(reinterpret_cast<char*>(val), sizeof(*val)); };
+
+  is.read(reinterpret_cast<char*>(m_counts.data()), m_counts.size() * sizeof(uint64_t));
+  read(&m_count);
+  read(&m_min);
+  read(&m_max);
+  read(&m_mean);
+  read(&m_m2);
+  if (!is)
+  {
+    throw Runtime_error("Histogram::load(): truncated input.");
+  }
+}
+
+uint64_t Histogram::count() const
+{
+  return m_count;
+}
+
+flow::Fine_duration Histogram::percentile(double pct) const
+{
+  using boost::chrono::nanoseconds;
+  using std::clamp;
+
+  if (m_count == 0)
+  {
+    return flow::Fine_duration::zero();
+  }
+  // else
+
+  // The sample of rank ceil(pct% * count) (1-based), at least the 1st one.
+  const auto rank = std::max(uint64_t(std::ceil(pct / 100 * double(m_count))), uint64_t(1));
+  uint64_t n_so_far = 0;
+  size_t idx = 0;
+  for (; idx != m_counts.size(); ++idx)
+  {
+    n_so_far += m_counts[idx];
+    if (n_so_far >= rank)
+    {
+      break;
+    }
+  }
+  // The bucket is approximate; but never report outside the exactly-known range (e.g., with 1 sample this is exact).
+  return nanoseconds(nanoseconds::rep(clamp(bucket_highest_val(idx), m_min, m_max)));
+}
+
+flow::Fine_duration Histogram::min() const
+{
+  return boost::chrono::nanoseconds(boost::chrono::nanoseconds::rep(m_min));
+}
+
+flow::Fine_duration Histogram::max() const
+{
+  return boost::chrono::nanoseconds(boost::chrono::nanoseconds::rep(m_max));
+}
+
+flow::Fine_duration Histogram::mean() const
+{
+  return boost::chrono::nanoseconds(boost::chrono::nanoseconds::rep(std::llround(m_mean)));
+}
+
+double Histogram::coeff_of_variation() const
+{
+  if ((m_count < 2) || (m_mean == 0))
+  {
+    return 0;
+  }
+  // else
+  return std::sqrt(m_m2 / double(m_count - 1)) / m_mean;
+}
+
 void setup_logging(std::optional<flow::log::Simple_ostream_logger>* std_logger,
                    std::optional<flow::log::Async_file_logger>* log_logger,
-                   int argc, char const * const * argv, bool srv_else_cli)
+                   const Cmd_line& cmd_line, bool srv_else_cli, const std::string& log_file_sfx)
 {
-  using flow::util::String_view;
   using flow::util::ostream_op_string;
   using flow::log::Config;
   using flow::log::Sev;
@@ -105,7 +608,7 @@ void setup_logging(std::optional<flow::log::Simple_ostream_logger>* std_logger,
   // This is separate: the IPC/Flow logging will go into this file.
   const auto LOG_FILE = ostream_op_string(S_EXEC_PREFIX, srv_else_cli ? SRV_NAME : CLI_NAME, ".log");
   const size_t ARG_IDX = srv_else_cli ? 2 : 1;
-  const auto log_file = (size_t(argc) > ARG_IDX) ? String_view(argv[ARG_IDX]) : String_view(LOG_FILE);
+  const auto log_file = ((cmd_line.n_pos_args() > ARG_IDX) ? cmd_line.pos_arg(ARG_IDX) : LOG_FILE) + log_file_sfx;
   FLOW_LOG_INFO("Opening log file [" << log_file << "] for IPC/Flow logs only.");
   static auto log_config = std_log_config;
   log_config.configure_default_verbosity(Sev::S_INFO, true);
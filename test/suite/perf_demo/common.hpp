@@ -21,12 +21,20 @@
 #include <ipc/session/shm/arena_lend/jemalloc/session_server.hpp>
 #include <ipc/session/shm/classic/client_session.hpp>
 #include <ipc/session/shm/classic/session_server.hpp>
+#include <ipc/session/client_session.hpp>
+#include <ipc/session/session_server.hpp>
 #include <ipc/session/app.hpp>
 #include <flow/log/simple_ostream_logger.hpp>
 #include <flow/log/async_file_logger.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/lexical_cast.hpp>
+#include <array>
+#include <iosfwd>
 #include <string>
 #include <optional>
+#include <map>
+#include <type_traits>
+#include <vector>
 
 namespace fs = boost::filesystem;
 
@@ -42,31 +50,286 @@ using Error_code = flow::Error_code;
 using Runtime_error = flow::error::Runtime_error;
 using Blob = flow::util::Blob_sans_log_context;
 
-// Session will emit Unix-domain-socket-transport-based channels.  Structured-channels will be zero-copy-enabled.
-#if JEM_ELSE_CLASSIC
+/* Each pair of programs is built for 1 point in a matrix of 2 compile-time dimensions (see CMakeLists.txt, which
+ * builds them all; and run_matrix.sh, which runs them all):
+ *   - SHM_PROVIDER: which SHM-provider the session uses, hence how structured messages are backed: SHM-classic,
+ *     SHM-jemalloc; or none (i.e., a vanilla, non-SHM session: structured messages are serialized in heap and
+ *     copied through the transport; Channel_base::S_SERIALIZE_VIA_HEAP).
+ *   - MQ_TYPE: what the session's channels are made of: a Unix domain socket (MqType::NONE); or a pair of
+ *     POSIX MQs or bipc MQs (MqType::POSIX, MqType::BIPC).  We don't transmit native handles; so in the latter
+ *     case there's no socket in the channels at all.
+ * The 3rd dimension -- for SHM-backed builds, whether the SHM arena is per-session or per-app -- is chosen at
+ * run time (--serialize; see Serialize_via). */
+#define SHM_PROVIDER_NONE 0
+#define SHM_PROVIDER_CLASSIC 1
+#define SHM_PROVIDER_JEMALLOC 2
+
+#define MQ_TYPE_NONE 0
+#define MQ_TYPE_POSIX 1
+#define MQ_TYPE_BIPC 2
+
+#if SHM_PROVIDER == SHM_PROVIDER_JEMALLOC
 namespace ssn = ipc::session::shm::arena_lend::jemalloc;
-#else
+#elif SHM_PROVIDER == SHM_PROVIDER_CLASSIC
 namespace ssn = ipc::session::shm::classic;
+#elif SHM_PROVIDER == SHM_PROVIDER_NONE
+namespace ssn = ipc::session;
+#else
+#  error "Set SHM_PROVIDER to one of SHM_PROVIDER_{NONE|CLASSIC|JEMALLOC} values."
 #endif
 
-using Client_session = ssn::Client_session<ipc::session::schema::MqType::NONE, false>;
-using Session_server = ssn::Session_server<ipc::session::schema::MqType::NONE, false>;
-// We'll use an unstructured channel of this type (again, Unix domain socket underneath) to time non-zero-copy xmission.
+#if MQ_TYPE == MQ_TYPE_NONE
+constexpr auto S_MQ_TYPE = ipc::session::schema::MqType::NONE;
+#elif MQ_TYPE == MQ_TYPE_POSIX
+constexpr auto S_MQ_TYPE = ipc::session::schema::MqType::POSIX;
+#elif MQ_TYPE == MQ_TYPE_BIPC
+constexpr auto S_MQ_TYPE = ipc::session::schema::MqType::BIPC;
+#else
+#  error "Set MQ_TYPE to one of MQ_TYPE_{NONE|POSIX|BIPC} values."
+#endif
+
+using Client_session = ssn::Client_session<S_MQ_TYPE, false>;
+using Session_server = ssn::Session_server<S_MQ_TYPE, false>;
+// We'll use an unstructured channel of this type (e.g., Unix domain socket underneath) to time non-zero-copy xmission.
 using Channel_raw = Client_session::Channel_obj;
-// We'll use a structured channel of this type to time zero-copy transmission of capnp-backed structured data.
+/* We'll use a structured channel of this type to time zero-copy transmission of capnp-backed structured data.
+ * (Or, with SHM_PROVIDER_NONE, the non-zero-copy Flow-IPC way: Channel_via_heap.) */
 using Channel_struc = Client_session::Structured_channel<perf_demo::schema::Body>::Sync_io_obj;
+// The async-I/O-pattern counterparts of the above 2 (only in the --io-overhead benchmark; see Io_variant).
+using Channel_raw_aio = Channel_raw::Async_io_obj;
+using Channel_struc_aio = Client_session::Structured_channel<perf_demo::schema::Body>;
+
+/* How the structured channel serializes out-messages.  S_HEAP is the only choice (and the default) with
+ * SHM_PROVIDER_NONE; it is not available otherwise: with a SHM-enabled session the MQs (if any) are sized for tiny
+ * SHM handles, not for heap-serialized segments; and anyway S_HEAP over a vanilla session is the same thing.
+ * Otherwise S_SESSION_SHM (default) or S_APP_SHM.  Note: with SHM-jemalloc a session-client cannot allocate in
+ * app-scope; so with S_APP_SHM that client uses S_SESSION_SHM for its (tiny) requests regardless; it's the server's
+ * (large) responses that matter here anyway. */
+enum class Serialize_via
+{
+  S_HEAP,
+  S_SESSION_SHM,
+  S_APP_SHM
+};
+
+/* The server pre-builds a response per each of its rough data sizes and advertises them to the client in the
+ * handshake SYN of the raw-channel benchmark: 1 `size_t` per message (an MQ message can be quite small), then a 0.
+ * This is a sanity bound on how many there may be. */
+constexpr size_t MAX_N_SIZES = 64;
+
+/* The optional --io-overhead benchmark (see perf_demo_cli) sends a tiny message back and forth in each of these
+ * ways, one after another: each over its own channel.  (The client asks for N_IO_VARIANTS init-channels of its own,
+ * [i] being for variant i; that's how the server knows to run this benchmark at all.)  The sync_io-pattern objects
+ * do all their work in our event-loop thread; the async-I/O ones do the I/O in Flow-IPC's own background
+ * thread(s) W, whose completion handlers post() the rest back onto our event loop: the usual way to use them.
+ * So this measures what the async-I/O API costs in latency and context switches, compared to sync_io. */
+enum class Io_variant
+{
+  S_RAW_SYNC_IO,
+  S_RAW_ASYNC_IO,
+  S_STRUC_SYNC_IO,
+  S_STRUC_ASYNC_IO
+};
+constexpr size_t N_IO_VARIANTS = 4;
+
+/* The optional --ping-pong benchmark (see perf_demo_cli) bounces a message of each of these sizes back and forth:
+ * first over a raw channel, then over a struc::Channel.  The client asks for N_PING_PONG_CHANS init-channels for it
+ * (after the N_IO_VARIANTS ones for --io-overhead, if any): [0] is used raw; [1] is upgraded to struc::Channel.
+ * A size that the given channel cannot carry (see ping_pong_sz_ok()) is skipped: both sides agree on which. */
+constexpr std::array<size_t, 5> PING_PONG_SZS = { 8, 64, 1024, 16 * 1024, 64 * 1024 };
+constexpr size_t N_PING_PONG_CHANS = 2;
+/* The client's end-of-pings signal, on either channel, is a ping of this size (not echoed).  Not 0: a raw channel
+ * cannot send an empty blob.  So it must not be one of PING_PONG_SZS. */
+constexpr size_t PING_PONG_END_SZ = 1;
+static_assert([]() -> bool
+              {
+                for (const auto sz : PING_PONG_SZS)
+                {
+                  if (sz == PING_PONG_END_SZ)
+                  {
+                    return false;
+                  }
+                }
+                return true;
+              }(),
+              "The end-of-pings signal must not be a valid ping size.");
+
+// Context switches so far of this process (all of its threads); as reported by getrusage().
+struct Ctx_switches
+{
+  uint64_t m_voluntary = 0;
+  uint64_t m_involuntary = 0;
+};
+
+/* OS resource usage of this process (all of its threads) so far, as reported by getrusage() and (Linux)
+ * /proc/self/io.  The difference of 2 of these (operator-()) is the usage in between; less what taking the earlier
+ * one itself adds to the /proc/self/io counters (its own reads of that file; measured once: so take the earlier one
+ * with `with_shmem == false`, as that's how it's measured).  operator+=() accumulates such differences.  Except the
+ * "level" members at the bottom: those are not counters; the difference keeps the later value, and accumulation the
+ * max.  We want to relate a latency to its cause: copies (bytes), syscalls, page faults
+ * (e.g., 1st touch of a SHM mapping), or being switched out.  Note: /proc/self/io counts read()/write()-like calls
+ * (sockets included) but not mq_send()/mq_receive(); and a bipc MQ involves no syscalls (unless it blocks). */
+struct Res_usage
+{
+  Ctx_switches m_ctx_switches;
+  uint64_t m_minor_faults = 0;
+  uint64_t m_major_faults = 0;
+  // /proc/self/io syscr, syscw, rchar, wchar.  Zero if not available.
+  uint64_t m_read_syscalls = 0;
+  uint64_t m_write_syscalls = 0;
+  uint64_t m_read_bytes = 0;
+  uint64_t m_write_bytes = 0;
+
+  // Level: peak resident set size so far, in KiB.
+  uint64_t m_peak_rss_kib = 0;
+  // Level: resident shared memory (SHM among it), in KiB.  Only if asked (see res_usage()); else zero.
+  uint64_t m_shmem_rss_kib = 0;
+};
+
+/* What run_event_loop() did, if it busy-polled: event loop iterations that found work while spinning (so no sleep in
+ * the kernel, and no wakeup latency); and those that ran out of budget and went to sleep after all. */
+struct Busy_poll_stats
+{
+  uint64_t m_spin_hits = 0;
+  uint64_t m_fallbacks = 0;
+};
 
 using Task_engine = flow::util::Task_engine; // A/k/a boost::asio::io_context.
 using Asio_handle = ipc::util::sync_io::Asio_waitable_native_handle;
 using Blob_const = ipc::util::Blob_const;
 using Blob_mutable = ipc::util::Blob_mutable;
 
+/* Command line of either application: args of the form `--name=value` (or just `--name`, meaning `--name=1`)
+ * are options and can be anywhere; the rest are the positional args (as before: size, log file, etc.), indexed as in
+ * `argv` (so pos_arg(0) is the executable).  We're not serious enough here to bring in boost.program_options. */
+class Cmd_line
+{
+public:
+  explicit Cmd_line(int argc, char const * const * argv);
+
+  size_t n_pos_args() const;
+  const std::string& pos_arg(size_t idx) const;
+
+  // The value of option `name` (converted via lexical_cast); or `dflt` if not given.
+  template<typename Value>
+  Value opt(const std::string& name, const Value& dflt) const;
+
+private:
+  std::vector<std::string> m_pos_args;
+  std::map<std::string, std::string> m_opts;
+}; // class Cmd_line
+
+/* An HDR-histogram-style latency accumulator: each sample goes into one of a fixed set of log-linear buckets
+ * (1-nsec exact buckets up to 2^S_SUB_BUCKET_BITS nsec; then 2^S_SUB_BUCKET_BITS buckets per power of 2), so
+ * recording is O(1), memory is fixed, and any percentile is accurate to within ~1% relative.  (Min, max, mean,
+ * and standard deviation are tracked exactly.)  We want tail latencies over many rounds, not 1 noisy RTT. */
+class Histogram
+{
+public:
+  Histogram();
+
+  void record(flow::Fine_duration sample);
+  // As-if each sample recorded in `src` had been record()ed in `*this` too.
+  void merge(const Histogram& src);
+  /* Binary (same-machine) dump of the whole thing; and the reverse.  E.g., to pass results from one process
+   * to another.  load() throws on truncated input. */
+  void save(std::ostream& os) const;
+  void load(std::istream& is);
+
+  uint64_t count() const;
+  // `pct` in [0, 100]; e.g., 50 = median, 99.9 = p99.9.  Zero if empty.
+  flow::Fine_duration percentile(double pct) const;
+  flow::Fine_duration min() const;
+  flow::Fine_duration max() const;
+  flow::Fine_duration mean() const;
+  // Coefficient of variation: standard deviation / mean.  Zero if fewer than 2 samples.
+  double coeff_of_variation() const;
+
+private:
+  static constexpr unsigned int S_SUB_BUCKET_BITS = 7; // 128 sub-buckets per power of 2 => ~0.8% resolution.
+  static constexpr uint64_t S_N_SUB_BUCKETS = uint64_t(1) << S_SUB_BUCKET_BITS;
+
+  static size_t bucket_idx(uint64_t val);
+  static uint64_t bucket_highest_val(size_t idx);
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_min;
+  uint64_t m_max;
+  // Welford's running mean and sum of squared deviations (all in nsec).
+  double m_mean;
+  double m_m2;
+}; // class Histogram
+
 // Invoke from main() from either application to ensure it's being run directly from the expected CWD.
 void ensure_run_env(const char* argv0, bool srv_else_cli);
-// Invoke from main() to set up console and file logging.
+// Parses --serialize=<heap|session-shm|app-shm> (throws if it's not valid for this build; see Serialize_via).
+Serialize_via serialize_via(const Cmd_line& cmd_line);
+/* Describes this build's transport and the given serialization choice; e.g., for result summaries.  build_variant()
+ * is the name of this build in the matrix: the part of the executable name that identifies it (e.g., `shm_classic`,
+ * `heap_mq_posix`). */
+std::string build_variant();
+std::string transport_desc();
+std::string serialize_desc(Serialize_via serialize_via);
+std::string io_variant_desc(Io_variant variant);
+/* Whether a --ping-pong message with a blob of `sz` bytes can be sent over the raw (`struc_else_raw` false) or
+ * structured (true) channel of this build, whose raw channel can send blobs up to `max_blob_sz` bytes. */
+bool ping_pong_sz_ok(size_t sz, bool struc_else_raw, size_t max_blob_sz);
+/* Upgrades the given raw channel into *chan (which must be empty), according to `serialize_via`.
+ * `session` must be in PEER state.  Chan = Channel_struc or Channel_struc_aio. */
+template<typename Chan, typename Session>
+void emplace_channel_struc(std::optional<Chan>* chan, flow::log::Logger* logger_ptr, Channel_raw&& chan_raw,
+                           Session* session, Serialize_via serialize_via);
+Ctx_switches ctx_switches();
+/* See Res_usage.  Res_usage::m_shmem_rss_kib is filled only if `with_shmem` (it costs another /proc read; so leave it
+ * off in a timed section, where the reads of /proc/self/io already add ~1 syscall to each difference). */
+Res_usage res_usage(bool with_shmem = false);
+Res_usage operator-(const Res_usage& later, const Res_usage& earlier);
+Res_usage& operator+=(Res_usage& total, const Res_usage& diff);
+/* Prints a difference (or accumulation) of Res_usage, divided by `n` (e.g., so many rounds), compactly on 1 line.
+ * The levels are printed as-is. */
+std::string res_usage_desc(const Res_usage& diff, uint64_t n = 1);
+/* Equivalent to `asio->run()`, if `spin_budget` is zero.  Otherwise, whenever there's nothing to do, instead of
+ * sleeping in the kernel until there is, it keeps checking (non-blocking `asio->poll()`) for up to `spin_budget`;
+ * only then does it sleep (`asio->run_one()`).  That trades a core, spinning, for the wakeup latency of each receive
+ * (a few usec, plus scheduling).  Adds to `*stats`.  Note: each poll() is a non-blocking epoll_wait(); so this
+ * spins on the readiness of all the FDs the loop waits on at once, whatever they are (socket, POSIX MQ, ...). */
+void run_event_loop(Task_engine* asio, flow::Fine_duration spin_budget, Busy_poll_stats* stats);
+/* Invoke from main() to set up console and file logging.  `log_file_sfx` is appended to the log file name; so that
+ * several instances of an application running at once (see perf_demo_cli --clients) do not write the same file. */
 void setup_logging(std::optional<flow::log::Simple_ostream_logger>* std_logger,
                    std::optional<flow::log::Async_file_logger>* log_logger,
-                   int argc, char const * const * argv, bool srv_else_cli);
+                   const Cmd_line& cmd_line, bool srv_else_cli, const std::string& log_file_sfx = "");
 
 void ev_wait(Asio_handle* hndl_of_interest,
              bool ev_of_interest_snd_else_rcv, ipc::util::sync_io::Task_ptr&& on_active_ev_func);
+
+template<typename Chan, typename Session>
+void emplace_channel_struc(std::optional<Chan>* chan, flow::log::Logger* logger_ptr, Channel_raw&& chan_raw,
+                           Session* session, [[maybe_unused]] Serialize_via serialize_via)
+{
+  using ipc::transport::struc::Channel_base;
+
+#if SHM_PROVIDER == SHM_PROVIDER_NONE
+  assert(serialize_via == Serialize_via::S_HEAP);
+  chan->emplace(logger_ptr, std::move(chan_raw), Channel_base::S_SERIALIZE_VIA_HEAP, session->session_token());
+#else
+  constexpr bool APP_SHM_OK = (SHM_PROVIDER != SHM_PROVIDER_JEMALLOC) || (!std::is_same_v<Session, Client_session>);
+  if constexpr(APP_SHM_OK)
+  {
+    if (serialize_via == Serialize_via::S_APP_SHM)
+    {
+      chan->emplace(logger_ptr, std::move(chan_raw), Channel_base::S_SERIALIZE_VIA_APP_SHM, session);
+      return;
+    }
+  }
+  chan->emplace(logger_ptr, std::move(chan_raw), Channel_base::S_SERIALIZE_VIA_SESSION_SHM, session);
+#endif
+}
+
+template<typename Value>
+Value Cmd_line::opt(const std::string& name, const Value& dflt) const
+{
+  const auto it = m_opts.find(name);
+  return (it == m_opts.end()) ? dflt : boost::lexical_cast<Value>(it->second);
+}
@@ -19,107 +19,335 @@
  *
  * As is typical in these client-server test/demo programs, the 2 programs mirror each other.  So the comments
  * are generally in main_srv.cpp, and we keep it light here in main_cli.cpp; except where there's our-side-specific
- * stuff.  Please refer to the other file, as you go through this one. */
+ * stuff.  Please refer to the other file, as you go through this one.
+ *
+ * One thing that's only here: with --clients=K (to match the server's --clients=K) this program is the launcher of
+ * K clients at once.  It forks K child processes, each of which does exactly what this program normally does
+ * (its own session, its own benchmarks); except instead of printing a summary each child sends its results back
+ * to us over a pipe.  Then we print the results per client; and then the usual summary over all clients together. */
 
 #include "common.hpp"
 #include <flow/perf/checkpt_timer.hpp>
-
-void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan);
-void run_capnp_zero_cpy(flow::log::Logger* logger_ptr, Channel_struc* chan);
-void verify_rsp(const perf_demo::schema::GetCacheRsp::Reader& rsp_root);
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <poll.h>
+#include <signal.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// What to do in each benchmark: set from the command line.
+struct Bench_cfg
+{
+  // Request/response rounds per size, one at a time, each timed (RTT).
+  size_t m_n_iterations;
+  // If not zero: after those rounds, keep up to m_tput_window requests in flight for this long (throughput).
+  flow::Fine_duration m_tput_duration;
+  size_t m_tput_window;
+  // How the structured channel serializes (--serialize).
+  Serialize_via m_serialize_via;
+  // If not zero: afterwards run the sync_io-vs.-async-I/O benchmark, with this many round trips per Io_variant.
+  size_t m_io_overhead_rounds;
+  // If not zero: afterwards run the small-message ping-pong benchmark, with this many round trips per size (each way).
+  size_t m_ping_pong_rounds;
+  // If not zero: our event loop busy-polls for this long, when idle, before sleeping.  See run_event_loop().
+  flow::Fine_duration m_busy_poll;
+};
+
+// Results of the throughput phase of a benchmark, for 1 size.
+struct Throughput
+{
+  // Requests actually kept in flight.  (For the raw benchmark this may be less than configured; see there.)
+  size_t m_window = 0;
+  // Responses fully received during the phase; and how long it took.
+  uint64_t m_n_msgs = 0;
+  flow::Fine_duration m_elapsed = flow::Fine_duration::zero();
+};
+
+// Results of the benchmarks for 1 of the response sizes advertised by the server.
+struct Result
+{
+  // Rough size requested; as advertised by server.
+  size_t m_req_sz = 0;
+  // Byte count inside the transmitted data.  1st benchmark sets it; 2nd benchmark ensures it got same-sized data too.
+  size_t m_total_sz = 0;
+  // RTT of each request/response round (just 1, unless --iterations given).
+  Histogram m_capnp_over_raw_rtts;
+  Histogram m_capnp_zero_cpy_rtts;
+  // Only if Bench_cfg::m_tput_duration is not zero.
+  Throughput m_capnp_over_raw_tput;
+  Throughput m_capnp_zero_cpy_tput;
+  /* OS resource usage over the timed part of each of the rounds (the ones in the RTT histograms above): summed.
+   * Plus the levels as of the end of the last round.  See Res_usage. */
+  Res_usage m_capnp_over_raw_usage;
+  Res_usage m_capnp_zero_cpy_usage;
+  /* Raw benchmark (rounds and throughput phase): messages received; and how many times we had to wait for the
+   * channel to become readable first.  The ratio is how many messages each such wakeup drained (the rest arrived
+   * synchronously); i.e., what a batched receive could save. */
+  uint64_t m_capnp_over_raw_n_msgs = 0;
+  uint64_t m_capnp_over_raw_n_wakeups = 0;
+};
+
+// Results of the --io-overhead benchmark for 1 Io_variant.
+struct Io_overhead_result
+{
+  // RTT of each round trip.
+  Histogram m_rtts;
+  // Over all of those round trips together.
+  Ctx_switches m_ctx_switches;
+};
+using Io_overhead_results = std::array<Io_overhead_result, N_IO_VARIANTS>;
+
+// Results of the --ping-pong benchmark for 1 of PING_PONG_SZS, over 1 channel.
+struct Ping_pong_result
+{
+  // Whether it ran at all: `false` if the channel cannot carry this size (see ping_pong_sz_ok()).
+  bool m_ok = false;
+  // Half of each round trip's RTT.
+  Histogram m_one_way;
+  // The pipelined phase; its window is Bench_cfg::m_tput_window (or less).
+  Throughput m_tput;
+};
+// [0] is over the raw channel; [1] over the structured one.  Then [i] is for PING_PONG_SZS[i].
+using Ping_pong_results = std::array<std::array<Ping_pong_result, PING_PONG_SZS.size()>, 2>;
+
+// A client process forked by the --clients launcher; and the read end of the pipe over which it'll send its results.
+struct Child
+{
+  pid_t m_pid;
+  int m_results_fd;
+};
+
+void run_client(flow::log::Logger* std_logger_ptr, flow::log::Logger* log_logger_ptr, const char* argv0,
+                const Bench_cfg& cfg);
+void collect_clients(flow::log::Logger* logger_ptr, const std::vector<Child>& children, const Bench_cfg& cfg);
+void save_results(std::ostream& os);
+std::vector<Result> load_results(std::istream& is, Io_overhead_results* io_overhead, Ping_pong_results* ping_pong);
+void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan, const Bench_cfg& cfg);
+void run_capnp_zero_cpy(flow::log::Logger* logger_ptr, Channel_struc* chan, const Bench_cfg& cfg);
+void run_io_overhead(flow::log::Logger* logger_ptr, Channel_raw* raw_sio, Channel_raw_aio* raw_aio,
+                     Channel_struc* struc_sio, Channel_struc_aio* struc_aio, const Bench_cfg& cfg);
+void run_ping_pong(flow::log::Logger* logger_ptr, Channel_raw* raw, Channel_struc* struc, const Bench_cfg& cfg);
+void run_g_asio(flow::log::Logger* logger_ptr, const Bench_cfg& cfg);
+void verify_rsp(const perf_demo::schema::GetCacheRsp::Reader& rsp_root, Result* result);
+void log_summary(flow::log::Logger* logger_ptr, const Bench_cfg& cfg);
+void save_report(flow::log::Logger* logger_ptr, const Bench_cfg& cfg, size_t n_clients,
+                 const std::string& json_path, const std::string& csv_path);
 
 using Timer = flow::perf::Checkpointing_timer;
 using Clock_type = flow::perf::Clock_type;
 
 static Task_engine g_asio;
-/* These globals (which, again, don't really need to be global but are just for expediency for now at least, as they're
- * referenced in a few benchmarks) are set by diff benchmarks and then summarized/analyzed a bit at the end of
- * main(). */
-static flow::Fine_duration g_capnp_over_raw_rtt;
-static flow::Fine_duration g_capnp_zero_cpy_rtt;
-// Byte count inside the transmitted data.  1st benchmark sets it; 2nd benchmarks ensures it got same-sized data too.
-static size_t g_total_sz = 0;
+/* This global (which, again, doesn't really need to be global but is just for expediency for now at least, as it's
+ * referenced in a few benchmarks) is loaded by the 1st benchmark (1 element per size the server advertised),
+ * filled-out by diff benchmarks, and then summarized/analyzed a bit at the end of main(). */
+static std::vector<Result> g_results;
+// Similarly for the --io-overhead and --ping-pong benchmarks.
+static Io_overhead_results g_io_overhead;
+static Ping_pong_results g_ping_pong;
 
 int main(int argc, char const * const * argv)
 {
-  using Session = Client_session;
   using flow::log::Simple_ostream_logger;
   using flow::log::Async_file_logger;
   using flow::Flow_log_component;
-  using flow::util::ceil_div;
-  using boost::promise;
-  using boost::chrono::microseconds;
-  using boost::chrono::round;
+  using boost::lexical_cast;
   using std::exception;
   using std::optional;
+  using std::string;
+  using std::vector;
+
+  const Cmd_line cmd_line(argc, argv);
+
+  /* The options, other than --clients (see below) and --serialize (see Serialize_via), tune the benchmark run:
+   *   - By default each benchmark does 1 request/response round per size; in that case the RTT is subject to quite
+   *     a bit of run-to-run jitter (see log_summary()).  With --iterations=N (e.g., thousands) it does N rounds per
+   *     size instead and reports the distribution (percentiles, max, coefficient of variation).  Tail latency is
+   *     what matters in production after all.  (Either way each size begins with 1 more, untimed, warm-up round:
+   *     the server, if it has just the 1 client, prepares the response for a size when first asked for it.)
+   *   - With --throughput-secs=S each benchmark, after those rounds, keeps --window=W requests in flight
+   *     (pipelined) for S seconds per size and reports messages/sec and GiB/sec.  That's the many-concurrent-gets
+   *     scenario: latency is one thing, but where does the channel saturate?
+   *   - With --io-overhead=N, after the capnp benchmarks, a tiny message makes N round trips via the sync_io API,
+   *     then N via the async-I/O one; for raw and structured channels both (see Io_variant).  Then we report the
+   *     latency difference and context switches per round trip.
+   *   - With --ping-pong=N, after that, blobs of each of PING_PONG_SZS (8 B to 64 KiB) are bounced back and forth
+   *     N times; then N more with up to --window in flight; over a raw channel and a structured one.  We report
+   *     one-way latency (half the RTT) percentiles and messages/sec.  Control traffic tends to be small messages,
+   *     so these are the numbers that matter for it; and, run on each build of the matrix, they compare the
+   *     transports.
+   *   - With --busy-poll-usec=U our event loop, whenever idle, busy-polls for up to U usec before going to sleep in
+   *     the kernel; which would cost a wakeup on each response.  (Give the server the same option, for its
+   *     requests.)  That is a core's worth of CPU for lower, and less jittery, latency; see run_event_loop().
+   *     Compare the RTTs with and without.
+   *   - The summary is printed to the console as always; but with --json=<file> and/or --csv=<file> it's also
+   *     saved there, in machine-readable form, along with the build configuration and environment (see
+   *     save_report()).  See perf_gate.sh: it uses that to catch regressions against a stored baseline.
+   *
+   * Bad options throw; but there's no logger yet to report it (see below for why); so save the error for later,
+   * and don't launch anything. */
+  Bench_cfg cfg{ 1, flow::Fine_duration::zero(), 1, Serialize_via::S_HEAP, 0, 0, flow::Fine_duration::zero() };
+  size_t n_clients = 1;
+  string json_path;
+  string csv_path;
+  string cfg_err;
+  try
+  {
+    cfg = { cmd_line.opt<size_t>("iterations", 1),
+            boost::chrono::duration_cast<flow::Fine_duration>
+              (boost::chrono::duration<double>(cmd_line.opt<double>("throughput-secs", 0))),
+            cmd_line.opt<size_t>("window", 16),
+            serialize_via(cmd_line),
+            cmd_line.opt<size_t>("io-overhead", 0),
+            cmd_line.opt<size_t>("ping-pong", 0),
+            boost::chrono::microseconds(cmd_line.opt<size_t>("busy-poll-usec", 0)) };
+    n_clients = cmd_line.opt<size_t>("clients", 1);
+    json_path = cmd_line.opt<string>("json", "");
+    csv_path = cmd_line.opt<string>("csv", "");
+  }
+  catch (const exception& exc)
+  {
+    cfg_err = exc.what();
+  }
+
+  /* With --clients=K > 1 fork the K clients right away: before anything (e.g., a logger) starts a thread or
+   * otherwise sets up state that would not survive fork().  A child just continues below as if it were a
+   * regular 1-client invocation, except it knows its index and where to send its results. */
+  vector<Child> children;
+  Error_code fork_err_code;
+  optional<size_t> child_idx;
+  int results_fd = -1;
+  for (size_t idx = 0; (n_clients > 1) && (idx != n_clients); ++idx)
+  {
+    int pipe_fds[2];
+    if (::pipe(pipe_fds) == -1)
+    {
+      fork_err_code = Error_code(errno, boost::system::system_category());
+      break;
+    }
+    // else
+    const auto pid = ::fork();
+    if (pid == -1)
+    {
+      fork_err_code = Error_code(errno, boost::system::system_category());
+      ::close(pipe_fds[0]);
+      ::close(pipe_fds[1]);
+      break;
+    }
+    // else
+    if (pid == 0)
+    {
+      // Child.  We only need the write end of our own pipe.
+      ::close(pipe_fds[0]);
+      for (const auto& child : children)
+      {
+        ::close(child.m_results_fd);
+      }
+      children.clear();
+      child_idx = idx;
+      results_fd = pipe_fds[1];
+      break;
+    }
+    // else: Parent.
+    ::close(pipe_fds[1]);
+    children.push_back({ pid, pipe_fds[0] });
+  } // for (idx in [0, n_clients))
 
   /* Set up logging within this function.  We could easily just use `cout` and `cerr` instead, but this
    * Flow stuff will give us time stamps and such for free, so why not?  Normally, one derives from
    * Log_context to do this very trivially, but we just have the one function, main(), so far so: */
   optional<Simple_ostream_logger> std_logger;
   optional<Async_file_logger> log_logger;
-  setup_logging(&std_logger, &log_logger, argc, argv, false);
+  setup_logging(&std_logger, &log_logger, cmd_line, false,
+                child_idx ? ('.' + lexical_cast<string>(*child_idx + 1)) : string());
   FLOW_LOG_SET_CONTEXT(&(*std_logger), Flow_log_component::S_UNCAT);
 
-#if JEM_ELSE_CLASSIC
+  FLOW_LOG_INFO("Usage: " << argv[0] << " [<log file>] [--iterations=<request/response rounds per size (default 1)>] "
+                "[--throughput-secs=<pipelined phase duration per size (default 0 = skip)>] "
+                "[--window=<requests in flight in that phase (default 16)>] "
+                "[--clients=<client processes to launch at once; must match server's --clients (default 1)>] "
+                "[--serialize=<session-shm (default) | app-shm | heap (default, and only choice, in *_heap* build)>; "
+                "should match server's --serialize>] "
+                "[--io-overhead=<round trips per way, in sync_io vs. async-I/O benchmark (default 0 = skip)>] "
+                "[--ping-pong=<round trips per size, in small-message benchmark (default 0 = skip)>] "
+                "[--busy-poll-usec=<spin this long when idle, before sleeping (default 0 = never spin)>] "
+                "[--json=<file to save results to, as JSON>] [--csv=<same but CSV>]");
+
+#if SHM_PROVIDER == SHM_PROVIDER_JEMALLOC
   ipc::session::shm::arena_lend::Borrower_shm_pool_collection_repository_singleton::get_instance()
     .set_logger(&(*log_logger));
 #endif
 
   try
   {
-    ensure_run_env(argv[0], false);
-
-    Session session(&(*log_logger),
-                    CLI_APPS.find(CLI_NAME)->second,
-                    SRV_APPS.find(SRV_NAME)->second, [](const Error_code&) {});
-
-    FLOW_LOG_INFO("Session-client attempting to open session against session-server; "
-                  "it'll either succeed or fail very soon.");
-
-    Session::Channels chans;
-    session.sync_connect(session.mdt_builder(), nullptr, nullptr, &chans); // Let it throw on error.
-    FLOW_LOG_INFO("Session/channels opened.");
-
-    assert(chans.size() == 2); // Server shall offer us 2 channels.  (We could also ask for some above, but we won't.)
+    if (!cfg_err.empty())
+    {
+      throw Runtime_error(cfg_err);
+    }
+    if ((cfg.m_n_iterations == 0) || (cfg.m_tput_window == 0) || (n_clients == 0))
+    {
+      throw Runtime_error("--iterations, --window, and --clients must be at least 1.");
+    }
+    if (fork_err_code)
+    {
+      for (const auto& child : children)
+      {
+        ::kill(child.m_pid, SIGTERM); // They'd only wait forever for the server to accept the ones not launched.
+        ::close(child.m_results_fd);
+        ::waitpid(child.m_pid, nullptr, 0);
+      }
+      throw Runtime_error(fork_err_code, "pipe()/fork() of a client");
+    }
+    // else
 
-    auto& chan_raw = chans[0]; // Binary channel for raw-ish tests.
-    Channel_struc chan_struc(&(*log_logger), std::move(chans[1]), // Structured channel: SHM-backed underneath.
-                             ipc::transport::struc::Channel_base::S_SERIALIZE_VIA_SESSION_SHM, &session);
+    if (!children.empty())
+    {
+      FLOW_LOG_INFO("Launched [" << children.size() << "] client processes; their logs will be in log file(s) "
+                    "with suffix [.<client number>].  Waiting for them to finish.");
+      collect_clients(&(*std_logger), children, cfg);
+      save_report(&(*std_logger), cfg, n_clients, json_path, csv_path);
+      FLOW_LOG_INFO("Exiting.");
+      return 0;
+    }
+    // else: A regular client (maybe 1 of several).
 
-    run_capnp_over_raw(&(*std_logger), &chan_raw); // Benchmark 1.  capnp data transmission without Flow-IPC zero-copy.
-    run_capnp_zero_cpy(&(*std_logger), &chan_struc); // Benchmark 2.  Same but with it.
+    run_client(&(*std_logger), &(*log_logger), argv[0], cfg);
 
-    /* They already printed detailed timing info; now let's summarize the total results.  As you can see it
-     * just prints b1's RTT, b2's RTT, and the ratio; while reminding how much data was transmitted.
-     * (Ultimately b2's RTT will always be about the same and small; whereas b1's involves a bunch of copying
-     * into/out of tranport and hence will be proportional to data size.)
-     *
-     * The only subtlety is that we coarsen the RTT to be a multiple of 100us, rounding up.  Reason: It's not
-     * bulletproof, and it might be different on slower machines, but for now I've found this to be decent in practice:
-     * There's quite a bit of variation for a small message's RTT, maybe +/- 50us; and the total tends to be, if
-     * rounded to nearest 100us, at least 100us.  Furthermore, if sending small messages, sometimes there are
-     * paradoxical-ish results like b1-RTT/b2-RTT < 1, but really they're both around 100us, so it's more like 1.
-     * Once total_sz is increased beyond 10k-or-so, this stuff falls away and the coarsening to 100us-multiples
-     * doesn't really matter anyway and is easier to read.
-     *
-     * Maybe that's silliness.  In any case the un-coarsened detailed results are printed by run_*(); here
-     * we're summarizing.  @todo Revisit. */
-
-    const auto raw_rtt = ceil_div(round<microseconds>(g_capnp_over_raw_rtt).count(), microseconds::rep(100)) * 100;
-    const auto zcp_rtt = ceil_div(round<microseconds>(g_capnp_zero_cpy_rtt).count(), microseconds::rep(100)) * 100;
-
-    FLOW_LOG_INFO("Benchmark summary (rounded-up to 100-usec multiples): ");
-    FLOW_LOG_INFO("Transmission of ~[" << (g_total_sz / 1024) << " ki] of Cap'n Proto structured data: ");
-    FLOW_LOG_INFO("Via raw-local-stream-socket: RTT = [" << raw_rtt << " usec].");
-    FLOW_LOG_INFO("Via-zero-copy-Flow-IPC-channel ("
-#if JEM_ELSE_CLASSIC
-                  "SHM-jemalloc-backed"
-#else
-                  "SHM-classic-backed"
-#endif
-                  "): RTT = [" << zcp_rtt << " usec].");
-    FLOW_LOG_INFO("Ratio = [" << float(raw_rtt) / float(zcp_rtt) << "].");
+    if (child_idx)
+    {
+      std::ostringstream os;
+      save_results(os);
+      const auto data = os.str();
+      for (size_t n_sent = 0; n_sent != data.size(); )
+      {
+        const auto n = ::write(results_fd, data.data() + n_sent, data.size() - n_sent);
+        if (n == -1)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          // else
+          throw Runtime_error(Error_code(errno, boost::system::system_category()), "write() of results");
+        }
+        n_sent += size_t(n);
+      }
+      ::close(results_fd);
+    }
+    else
+    {
+      log_summary(&(*std_logger), cfg);
+      save_report(&(*std_logger), cfg, n_clients, json_path, csv_path);
+    }
 
     FLOW_LOG_INFO("Exiting.");
   } // try
@@ -134,20 +362,361 @@ int main(int argc, char const * const * argv)
   return 0;
 } // main()
 
-void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
+void run_client(flow::log::Logger* std_logger_ptr, flow::log::Logger* log_logger_ptr, const char* argv0,
+                const Bench_cfg& cfg)
+{
+  using Session = Client_session;
+  using flow::Flow_log_component;
+
+  FLOW_LOG_SET_CONTEXT(std_logger_ptr, Flow_log_component::S_UNCAT);
+
+  ensure_run_env(argv0, false);
+
+  Session session(log_logger_ptr,
+                  CLI_APPS.find(CLI_NAME)->second,
+                  SRV_APPS.find(SRV_NAME)->second, [](const Error_code&) {});
+
+  FLOW_LOG_INFO("Session-client attempting to open session against session-server; "
+                "it'll either succeed or fail very soon.");
+
+  /* Server shall offer us 2 channels.  We ask for some of our own only for the --io-overhead benchmark: 1 per
+   * Io_variant; and for the --ping-pong one: N_PING_PONG_CHANS more.  (That's how the server knows to run them.) */
+  Session::Channels chans;
+  const size_t n_io_chans = (cfg.m_io_overhead_rounds == 0) ? 0 : N_IO_VARIANTS;
+  Session::Channels io_chans(n_io_chans + ((cfg.m_ping_pong_rounds == 0) ? 0 : N_PING_PONG_CHANS));
+  session.sync_connect(session.mdt_builder(), io_chans.empty() ? nullptr : &io_chans,
+                       nullptr, &chans); // Let it throw on error.
+  FLOW_LOG_INFO("Session/channels opened.");
+
+  assert(chans.size() == 2);
+
+  auto& chan_raw = chans[0]; // Binary channel for raw-ish tests.
+  std::optional<Channel_struc> chan_struc; // Structured channel: SHM-backed underneath (unless --serialize=heap).
+  emplace_channel_struc(&chan_struc, log_logger_ptr, std::move(chans[1]), &session, cfg.m_serialize_via);
+
+  // Benchmark 1.  capnp data transmission without Flow-IPC zero-copy.
+  run_capnp_over_raw(std_logger_ptr, &chan_raw, cfg);
+  // Benchmark 2.  Same but with it.
+  run_capnp_zero_cpy(std_logger_ptr, &(*chan_struc), cfg);
+
+  if (cfg.m_io_overhead_rounds != 0)
+  {
+    // Benchmark 3.  sync_io versus async-I/O API, with tiny messages.
+    auto raw_aio = io_chans[size_t(Io_variant::S_RAW_ASYNC_IO)].async_io_obj();
+    std::optional<Channel_struc> struc_sio;
+    std::optional<Channel_struc_aio> struc_aio;
+    emplace_channel_struc(&struc_sio, log_logger_ptr, std::move(io_chans[size_t(Io_variant::S_STRUC_SYNC_IO)]),
+                          &session, cfg.m_serialize_via);
+    emplace_channel_struc(&struc_aio, log_logger_ptr, std::move(io_chans[size_t(Io_variant::S_STRUC_ASYNC_IO)]),
+                          &session, cfg.m_serialize_via);
+    run_io_overhead(std_logger_ptr, &io_chans[size_t(Io_variant::S_RAW_SYNC_IO)], &raw_aio,
+                    &(*struc_sio), &(*struc_aio), cfg);
+  }
+
+  if (cfg.m_ping_pong_rounds != 0)
+  {
+    // Benchmark 4.  Small messages of various sizes.
+    std::optional<Channel_struc> struc;
+    emplace_channel_struc(&struc, log_logger_ptr, std::move(io_chans[n_io_chans + 1]), &session, cfg.m_serialize_via);
+    run_ping_pong(std_logger_ptr, &io_chans[n_io_chans], &(*struc), cfg);
+  }
+} // run_client()
+
+void collect_clients(flow::log::Logger* logger_ptr, const std::vector<Child>& children, const Bench_cfg& cfg)
+{
+  using flow::Flow_log_component;
+  using boost::chrono::microseconds;
+  using boost::chrono::round;
+  using std::string;
+  using std::vector;
+  using std::setw;
+  using std::setprecision;
+  using std::fixed;
+
+  FLOW_LOG_SET_CONTEXT(logger_ptr, Flow_log_component::S_UNCAT);
+
+  /* Gather each child's results (it sends them when done, then exits).  They're large-ish (all those histograms):
+   * way more than a pipe holds; so read from all the pipes at once, as data arrive: otherwise each child would sit
+   * blocked in write() (unable to exit) until we got around to it. */
+  vector<string> datas(children.size());
+  {
+    vector<::pollfd> fds;
+    for (const auto& child : children)
+    {
+      fds.push_back({ child.m_results_fd, POLLIN, 0 });
+    }
+    std::array<char, 64 * 1024> buf;
+    for (size_t n_open = fds.size(); n_open != 0; )
+    {
+      if (::poll(fds.data(), fds.size(), -1) == -1)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        // else
+        throw Runtime_error(Error_code(errno, boost::system::system_category()), "poll() of results pipes");
+      }
+      // else
+      for (size_t idx = 0; idx != fds.size(); ++idx)
+      {
+        auto& fd = fds[idx];
+        if ((fd.fd == -1) || (fd.revents == 0))
+        {
+          continue;
+        }
+        // else
+        const auto n = ::read(fd.fd, buf.data(), buf.size());
+        if (n > 0)
+        {
+          datas[idx].append(buf.data(), size_t(n));
+        }
+        else if ((n == 0) || (errno != EINTR))
+        {
+          // EOF (or error: then the data are incomplete, which load_results() or the exit status will reveal).
+          ::close(fd.fd);
+          fd.fd = -1; // poll() ignores it from now on.
+          --n_open;
+        }
+      }
+    }
+  }
+
+  vector<vector<Result>> all_results;
+  vector<Io_overhead_results> all_io_overhead;
+  vector<Ping_pong_results> all_ping_pong;
+  bool all_ok = true;
+  for (size_t idx = 0; idx != children.size(); ++idx)
+  {
+    const auto& child = children[idx];
+    const auto& data = datas[idx];
+
+    int status;
+    while ((::waitpid(child.m_pid, &status, 0) == -1) && (errno == EINTR)) {}
+    if ((!WIFEXITED(status)) || (WEXITSTATUS(status) != 0) || data.empty())
+    {
+      FLOW_LOG_WARNING("Client [" << (idx + 1) << "] (PID [" << child.m_pid << "]) failed; see its output.");
+      all_ok = false;
+      continue;
+    }
+    // else
+    std::istringstream is(data);
+    all_results.push_back(load_results(is, &all_io_overhead.emplace_back(), &all_ping_pong.emplace_back()));
+  }
+  if (!all_ok)
+  {
+    throw Runtime_error("Not all clients succeeded.");
+  }
+  // else
+
+  const auto to_usec = [](flow::Fine_duration dur) -> auto { return round<microseconds>(dur).count(); };
+  const auto msgs_per_sec = [](const Throughput& tput) -> double
+  {
+    const double secs = boost::chrono::duration<double>(tput.m_elapsed).count();
+    return (secs == 0) ? 0 : (double(tput.m_n_msgs) / secs);
+  };
+
+  FLOW_LOG_INFO("Per-client results; RTTs in usec (medians, unless --iterations=1)"
+                << ((cfg.m_tput_duration == flow::Fine_duration::zero()) ? "" : "; throughput in msgs/sec") << ": ");
+  FLOW_LOG_INFO(setw(6) << "client" << " | " << setw(12) << "size (ki)" << " | "
+                << setw(10) << "raw RTT" << " | " << setw(14) << "zero-copy RTT" << " | "
+                << setw(12) << "raw tput" << " | " << setw(14) << "zero-copy tput");
+  for (size_t idx = 0; idx != all_results.size(); ++idx)
+  {
+    for (const auto& result : all_results[idx])
+    {
+      FLOW_LOG_INFO(setw(6) << (idx + 1) << " | " << setw(12) << (result.m_total_sz / 1024) << " | "
+                    << setw(10) << to_usec(result.m_capnp_over_raw_rtts.percentile(50)) << " | "
+                    << setw(14) << to_usec(result.m_capnp_zero_cpy_rtts.percentile(50)) << " | "
+                    << setw(12) << fixed << setprecision(0) << msgs_per_sec(result.m_capnp_over_raw_tput) << " | "
+                    << setw(14) << fixed << setprecision(0) << msgs_per_sec(result.m_capnp_zero_cpy_tput));
+    }
+  }
+
+  /* Now combine them into g_results, as if it were all 1 client, and summarize as usual.  The RTT distributions
+   * are simply merged.  For throughput: the total in-flight window and the total responses, over the slowest client's
+   * throughput phase (they all ran at once, give or take); so that's the aggregate rate the server sustained. */
+  g_results = all_results.front();
+  for (size_t idx = 1; idx != all_results.size(); ++idx)
+  {
+    const auto& results = all_results[idx];
+    if (results.size() != g_results.size())
+    {
+      throw Runtime_error("Clients got different numbers of sizes from the server?!");
+    }
+    // else
+    for (size_t size_idx = 0; size_idx != results.size(); ++size_idx)
+    {
+      auto& result = g_results[size_idx];
+      const auto& src = results[size_idx];
+      result.m_capnp_over_raw_rtts.merge(src.m_capnp_over_raw_rtts);
+      result.m_capnp_zero_cpy_rtts.merge(src.m_capnp_zero_cpy_rtts);
+      // Counters add up (so that per-round figures stay per-round); levels are the max over the processes.
+      result.m_capnp_over_raw_usage += src.m_capnp_over_raw_usage;
+      result.m_capnp_zero_cpy_usage += src.m_capnp_zero_cpy_usage;
+      result.m_capnp_over_raw_n_msgs += src.m_capnp_over_raw_n_msgs;
+      result.m_capnp_over_raw_n_wakeups += src.m_capnp_over_raw_n_wakeups;
+      for (const auto raw_else_zcp : { true, false })
+      {
+        auto& tput = raw_else_zcp ? result.m_capnp_over_raw_tput : result.m_capnp_zero_cpy_tput;
+        const auto& src_tput = raw_else_zcp ? src.m_capnp_over_raw_tput : src.m_capnp_zero_cpy_tput;
+        tput.m_window += src_tput.m_window;
+        tput.m_n_msgs += src_tput.m_n_msgs;
+        tput.m_elapsed = std::max(tput.m_elapsed, src_tput.m_elapsed);
+      }
+    }
+  }
+  // Same for the --io-overhead results.  The context switch counts are per-process; so they simply add up.
+  g_io_overhead = all_io_overhead.front();
+  for (size_t idx = 1; idx != all_io_overhead.size(); ++idx)
+  {
+    for (size_t variant_idx = 0; variant_idx != N_IO_VARIANTS; ++variant_idx)
+    {
+      auto& result = g_io_overhead[variant_idx];
+      const auto& src = all_io_overhead[idx][variant_idx];
+      result.m_rtts.merge(src.m_rtts);
+      result.m_ctx_switches.m_voluntary += src.m_ctx_switches.m_voluntary;
+      result.m_ctx_switches.m_involuntary += src.m_ctx_switches.m_involuntary;
+    }
+  }
+  // And the --ping-pong ones: same as the other benchmarks' results above.
+  g_ping_pong = all_ping_pong.front();
+  for (size_t idx = 1; idx != all_ping_pong.size(); ++idx)
+  {
+    for (size_t chan_idx = 0; chan_idx != g_ping_pong.size(); ++chan_idx)
+    {
+      for (size_t sz_idx = 0; sz_idx != PING_PONG_SZS.size(); ++sz_idx)
+      {
+        auto& result = g_ping_pong[chan_idx][sz_idx];
+        const auto& src = all_ping_pong[idx][chan_idx][sz_idx];
+        result.m_one_way.merge(src.m_one_way);
+        result.m_tput.m_window += src.m_tput.m_window;
+        result.m_tput.m_n_msgs += src.m_tput.m_n_msgs;
+        result.m_tput.m_elapsed = std::max(result.m_tput.m_elapsed, src.m_tput.m_elapsed);
+      }
+    }
+  }
+
+  FLOW_LOG_INFO("All [" << all_results.size() << "] clients together: ");
+  log_summary(logger_ptr, cfg);
+} // collect_clients()
+
+void save_results(std::ostream& os)
+{
+  const auto write = [&](const auto& val) { os.write(reinterpret_cast<const char*>(&val), sizeof(val)); };
+
+  write(g_results.size());
+  for (const auto& result : g_results)
+  {
+    write(result.m_req_sz);
+    write(result.m_total_sz);
+    result.m_capnp_over_raw_rtts.save(os);
+    result.m_capnp_zero_cpy_rtts.save(os);
+    for (const auto* tput : { &result.m_capnp_over_raw_tput, &result.m_capnp_zero_cpy_tput })
+    {
+      write(tput->m_window);
+      write(tput->m_n_msgs);
+      write(tput->m_elapsed);
+    }
+    write(result.m_capnp_over_raw_usage);
+    write(result.m_capnp_zero_cpy_usage);
+    write(result.m_capnp_over_raw_n_msgs);
+    write(result.m_capnp_over_raw_n_wakeups);
+  }
+  for (const auto& result : g_io_overhead)
+  {
+    result.m_rtts.save(os);
+    write(result.m_ctx_switches);
+  }
+  for (const auto& results : g_ping_pong)
+  {
+    for (const auto& result : results)
+    {
+      write(result.m_ok);
+      result.m_one_way.save(os);
+      write(result.m_tput.m_window);
+      write(result.m_tput.m_n_msgs);
+      write(result.m_tput.m_elapsed);
+    }
+  }
+}
+
+std::vector<Result> load_results(std::istream& is, Io_overhead_results* io_overhead, Ping_pong_results* ping_pong)
+{
+  const auto read = [&](auto* val) { is.read(reinterpret_cast<char*>(val), sizeof(*val)); };
+
+  size_t n_results = 0;
+  read(&n_results);
+  if ((!is) || (n_results > MAX_N_SIZES))
+  {
+    throw Runtime_error("load_results(): bad input.");
+  }
+  // else
+
+  std::vector<Result> results(n_results);
+  for (auto& result : results)
+  {
+    read(&result.m_req_sz);
+    read(&result.m_total_sz);
+    result.m_capnp_over_raw_rtts.load(is);
+    result.m_capnp_zero_cpy_rtts.load(is);
+    for (auto* tput : { &result.m_capnp_over_raw_tput, &result.m_capnp_zero_cpy_tput })
+    {
+      read(&tput->m_window);
+      read(&tput->m_n_msgs);
+      read(&tput->m_elapsed);
+    }
+    read(&result.m_capnp_over_raw_usage);
+    read(&result.m_capnp_zero_cpy_usage);
+    read(&result.m_capnp_over_raw_n_msgs);
+    read(&result.m_capnp_over_raw_n_wakeups);
+  }
+  for (auto& result : *io_overhead)
+  {
+    result.m_rtts.load(is);
+    read(&result.m_ctx_switches);
+  }
+  for (auto& results : *ping_pong)
+  {
+    for (auto& result : results)
+    {
+      read(&result.m_ok);
+      result.m_one_way.load(is);
+      read(&result.m_tput.m_window);
+      read(&result.m_tput.m_n_msgs);
+      read(&result.m_tput.m_elapsed);
+    }
+  }
+  if (!is)
+  {
+    throw Runtime_error("load_results(): truncated input.");
+  }
+  return results;
+}
+
+void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr, const Bench_cfg& cfg)
 {
   using flow::Flow_log_component;
   using flow::log::Logger;
   using flow::log::Log_context;
+  using flow::log::Sev;
   using flow::util::ceil_div;
   using ::capnp::word;
   using boost::asio::post;
+  using boost::chrono::round;
+  using boost::chrono::milliseconds;
   using std::vector;
 
   using Capnp_word_array_ptr = kj::ArrayPtr<const word>;
   using Capnp_word_array_array_ptr = kj::ArrayPtr<const Capnp_word_array_ptr>;
   using Capnp_heap_engine = ::capnp::SegmentArrayMessageReader;
 
+  /* In the throughput phase we keep up to this many bytes of responses in flight at most, regardless of --window.
+   * Reason: each response is copied into the transport by the server; and whatever doesn't fit into the kernel
+   * buffer waits in the server's outgoing queue (send_blob() never would-blocks).  So --window=16 x 1 Gi would
+   * be a lot of RAM.  (Not so for zero-copy, where only a small handle per response is copied.) */
+  constexpr size_t TPUT_MAX_BYTES_IN_FLIGHT = 256 * 1024 * 1024;
+
   /* Reminder: see main_srv.cpp run_capnp_over_raw() counterpart; we keep comments light except for client-specifics.
    *
    * In particular the couple comments there about how we could've had simpler code, had we used this or that technique,
@@ -158,22 +727,56 @@ void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
   struct Algo :
     public Log_context
   {
+    // What the next async_receive_blob() shall be receiving.
+    enum class Rcv_state
+    {
+      S_SYN,
+      S_HDR,
+      S_SEG
+    };
+
     Channel_raw& m_chan;
     Error_code m_err_code;
     size_t m_sz;
     size_t m_n;
     size_t m_n_segs;
+    /* The response header: [segment count N][N segment sizes] (see main_srv.cpp); and how many bytes of it we've got
+     * so far.  Until we know N, it's sized to hold 1 whole message of it (see expect_response()); then to fit. */
+    vector<size_t> m_hdr;
+    size_t m_hdr_rcvd_sz;
     vector<Blob> m_segs;
-    bool m_new_seg_next = true;
+    Rcv_state m_rcv_state = Rcv_state::S_SYN;
+    const Bench_cfg& m_cfg;
+    // Index into g_results of the response being requested/received currently; and which round for that size it is.
+    size_t m_result_idx = 0;
+    size_t m_iteration = 0;
+    /* Whether the current round is the untimed warm-up that precedes the m_cfg.m_n_iterations rounds of each size:
+     * the server prepares the response for a size upon the 1st request for it, and we don't want to time that. */
+    bool m_warm_up = false;
+    /* Throughput phase (after the m_cfg.m_n_iterations rounds): in it, the server handles the requests in order,
+     * so the responses simply arrive one after another in the stream; we only need to count them. */
+    bool m_tput_phase = false;
+    size_t m_n_in_flight = 0;
+    flow::Fine_time_pt m_tput_start;
+    flow::Fine_time_pt m_tput_end;
+    /* We log the goings-on of the 1st round for each size at INFO; the rest at TRACE: synchronous console logging
+     * would poison the timing (and flood the console) if --iterations is high. */
+    Sev m_sev = Sev::S_INFO;
     /* Server sends the stuff, but we time from just before sending request to just-after receiving and accessing reply.
      * Ctor call begins the timing; so wait until invoking it. */
     std::optional<Timer> m_timer;
+    // Resource usage as of just before m_timer began (see Result::m_capnp_over_raw_usage).
+    Res_usage m_usage_start;
+    // See Result::m_capnp_over_raw_n_msgs.  Reset by start_size().
+    uint64_t m_n_msgs = 0;
+    uint64_t m_n_wakeups = 0;
 
-    Algo(Logger* logger_ptr, Channel_raw* chan_ptr) :
+    Algo(Logger* logger_ptr, Channel_raw* chan_ptr, const Bench_cfg& cfg) :
       Log_context(logger_ptr, Flow_log_component::S_UNCAT),
-      m_chan(*chan_ptr)      
+      m_chan(*chan_ptr),
+      m_cfg(cfg)
     {
-      FLOW_LOG_INFO("-- RUN - capnp request/response over raw local-socket connection --");
+      FLOW_LOG_INFO("-- RUN - capnp request/response over raw " << transport_desc() << " connection --");
     }
 
     void start()
@@ -183,104 +786,78 @@ void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
       m_chan.start_receive_blob_ops(ev_wait);
 
       FLOW_LOG_INFO("< Expecting handshake SYN for initialization sync.");
-      m_chan.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), &m_err_code, &m_sz,
-                                [&](const Error_code& err_code, size_t) { on_sync(err_code); });
-      if (m_err_code != ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { on_sync(m_err_code); }
-    }
-
-    void on_sync(const Error_code& err_code)
-    {
-      if (err_code) { throw Runtime_error(err_code, "run_capnp_over_raw():on_sync()"); }
-
-      // Send a dummy message as a request signal, so we can start timing RTT before sending it.
-      FLOW_LOG_INFO("= Got handshake SYN.");
-
-      FLOW_LOG_INFO("> Issuing get-cache request via tiny message.");
-      m_timer.emplace(get_logger(), "capnp-raw", Timer::real_clock_types(), 100); // Begin timing.
-      m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
-      m_timer->checkpoint("sent request");
-
-      FLOW_LOG_INFO("< Expecting get-cache response fragment: capnp segment count.");
-      m_chan.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), &m_err_code, &m_sz,
-                                [&](const Error_code& err_code, size_t sz) { on_n_segs(err_code, sz); });
-      if (m_err_code != ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { on_n_segs(m_err_code, m_sz); }
+      g_results.clear(); // on_sync() fills it out, 1 size at a time.
+      read_blobs();
     }
 
-    void on_n_segs(const Error_code& err_code, [[maybe_unused]] size_t sz)
-    {
-      if (err_code) { throw Runtime_error(err_code, "run_capnp_over_raw():on_n_segs()"); }
-      assert((sz == sizeof(m_n)) && "First in-message should be capnp-segment count.");
-      assert(m_n != 0);
-
-      m_n_segs = m_n;
-      FLOW_LOG_INFO("= Got get-cache response fragment: capnp segment count = [" << m_n_segs << "].");
-      FLOW_LOG_INFO("< Expecting get-cache response fragments x N: [seg size, seg content...].");
-      m_timer->checkpoint("got seg-count");
-
-      m_segs.reserve(m_n_segs);
-
-      /* This is where the looping-read code is, and where we need to be careful to not start
-       * a recursion-loop (stack overflows-oh my) but rather an iteration-loop.  That is, if an async_X() yields
-       * would-block then return; if it yields error then explode; but if it yields success, then do *not*
-       * call our own function, or some function that would call our own function (that did the async_X()).
-       * Rather, loop around to the next async_X().
-       *
-       * So we just have a simple state machine (with 2 states):
-       * m_new_seg_next = true; read seg-size; m_new_seg_next = false; read blobs until seg-size bytes are ready,
-       * placing them contiguously into the currently-being-read segment;
-       * repeat (until m_n_segs segs have been obtained).
-       *
-       * We use a flow::util::Blob (a-la vector<uint8_t>) for each segment; its .capacity() = seg-size, while
-       * its .size() = how many bytes we've filled out already.  (It is formally allowed to write into the area
-       * [.end(), .begin() + capacity()).)
-       */
-      assert(m_new_seg_next);
-      read_segs();
-    }
-
-    void read_segs()
+    /* This is where the looping-read code is, and where we need to be careful to not start
+     * a recursion-loop (stack overflows-oh my) but rather an iteration-loop.  That is, if an async_X() yields
+     * would-block then return; if it yields error then explode; but if it yields success, then do *not*
+     * call our own function, or some function that would call our own function (that did the async_X()).
+     * Rather, loop around to the next async_X().
+     *
+     * So we just have a simple state machine (m_rcv_state):
+     * SYN (sizes, 1 per message, until 0) -> [send request] -> HDR (read blobs until the seg-count and all the
+     * seg-sizes are ready: normally 1 blob) -> SEG (read blobs until seg-size bytes are ready, placing them
+     * contiguously into the currently-being-read segment) -> SEG -> ... (until m_n_segs segs have been obtained) ->
+     * [send next request(s), if any] -> HDR -> ....
+     *
+     * We use a flow::util::Blob (a-la vector<uint8_t>) for each segment; its .capacity() = seg-size, while
+     * its .size() = how many bytes we've filled out already.  (It is formally allowed to write into the area
+     * [.end(), .begin() + capacity()).) */
+    void read_blobs()
     {
       do
       {
-        if (m_new_seg_next)
+        Blob_mutable target;
+        switch (m_rcv_state)
         {
-          m_chan.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), &m_err_code, &m_sz,
-                                    [&](const Error_code& err_code, size_t sz) { on_blob(err_code, sz); });
-        }
-        else
+        case Rcv_state::S_SYN:
+          target = Blob_mutable(&m_n, sizeof(m_n));
+          break;
+        case Rcv_state::S_HDR:
+          target = Blob_mutable(reinterpret_cast<uint8_t*>(m_hdr.data()) + m_hdr_rcvd_sz,
+                                (m_hdr.size() * sizeof(size_t)) - m_hdr_rcvd_sz);
+          break;
+        case Rcv_state::S_SEG:
         {
           auto& seg = m_segs.back();
-          m_chan.async_receive_blob(Blob_mutable(seg.end(), seg.capacity() - seg.size()), &m_err_code, &m_sz,
-                                    [&](const Error_code& err_code, size_t sz) { on_blob(err_code, sz); });
+          target = Blob_mutable(seg.end(), seg.capacity() - seg.size());
         }
+        } // switch (m_rcv_state)
+
+        m_chan.async_receive_blob(target, &m_err_code, &m_sz,
+                                  [&](const Error_code& err_code, size_t sz) { on_blob(err_code, sz); });
         if (m_err_code == ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { return; }
       }
-      while (!handle_blob(m_err_code, m_sz));
+      while (handle_blob(m_err_code, m_sz));
     }
 
     void on_blob(const Error_code& err_code, size_t sz)
     {
-      if (err_code) { throw Runtime_error(err_code, "run_capnp_over_raw():on_seg_sz()"); }
-      if (!handle_blob(err_code, sz))
+      ++m_n_wakeups;
+      if (handle_blob(err_code, sz))
       {
-        read_segs();
+        read_blobs();
       }
     }
 
+    // Returns `true` if and only if there's more to receive.
     bool handle_blob(const Error_code& err_code, size_t sz)
     {
-      if (err_code) { throw Runtime_error(err_code, "run_capnp_over_raw():on_seg_sz()"); }
-      if (m_new_seg_next)
+      if (err_code) { throw Runtime_error(err_code, "run_capnp_over_raw():handle_blob()"); }
+      ++m_n_msgs;
+      switch (m_rcv_state)
       {
-        m_new_seg_next = false;
-        assert(m_n != 0);
+      case Rcv_state::S_SYN:
+        on_sync(sz);
+        break; // (If that was the end of the list, on_sync() changed m_rcv_state and sent the 1st request.)
 
-        // New segment's size known; reserve the space and then set .size() = 0, while leaving .capacity() same.
-        m_segs.emplace_back(m_n);
-        m_segs.back().clear();
-        assert(m_segs.back().capacity() == m_n); // Ensure it didn't dealloc.
-      }
-      else
+      case Rcv_state::S_HDR:
+        on_hdr(sz);
+        break;
+
+      case Rcv_state::S_SEG:
       {
         // Register the received bytes; then see if we finished the segment with that; or maybe even the last one.
         auto& seg = m_segs.back();
@@ -294,18 +871,131 @@ void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
 
           if (m_segs.size() == m_n_segs)
           {
-            m_timer->checkpoint("got last seg");
+            checkpoint("got last seg");
             on_complete_response(); // Yay!  Next step of algo.
-            return true;
+            return on_response_done();
           }
-          m_timer->checkpoint("got a seg");
-          m_new_seg_next = true;
+          checkpoint("got a seg");
+          start_seg();
         }
       }
+      } // switch (m_rcv_state)
 
-      return false;
+      return true;
     } // handle_blob()
 
+    void on_sync([[maybe_unused]] size_t sz)
+    {
+      assert((sz == sizeof(m_n)) && "Handshake SYN should be a list of advertised sizes, 1 per message.");
+
+      if (m_n != 0)
+      {
+        if (g_results.size() == MAX_N_SIZES)
+        {
+          throw Runtime_error("Server advertises too many sizes.");
+        }
+        // else
+        g_results.emplace_back().m_req_sz = m_n;
+        return;
+      }
+      // else: End of list.
+
+      if (g_results.empty())
+      {
+        throw Runtime_error("Server advertises no sizes.");
+      }
+      // else
+      FLOW_LOG_INFO("= Got handshake SYN; server advertises [" << g_results.size() << "] response size(s).");
+
+      start_size();
+    }
+
+    // Begin the rounds (and then maybe throughput phase) for size g_results[m_result_idx].
+    void start_size()
+    {
+      m_iteration = 0;
+      m_warm_up = true;
+      m_tput_phase = false;
+      m_n_msgs = 0;
+      m_n_wakeups = 0;
+      issue_request();
+    }
+
+    void issue_request()
+    {
+      // Send a dummy-ish message as a request signal, so we can start timing RTT before sending it.
+      m_n = g_results[m_result_idx].m_req_sz;
+      m_sev = (m_iteration == 0) ? Sev::S_INFO : Sev::S_TRACE;
+      FLOW_LOG_WITH_CHECKING(m_sev, "> Issuing get-cache request via tiny message "
+                                    "(rough size [" << ceil_div(m_n, size_t(1024)) << " Ki]; "
+                                    "round [" << (m_iteration + 1) << '/' << m_cfg.m_n_iterations << "]"
+                                    << (m_warm_up ? ", untimed warm-up" : "") << ").");
+      m_usage_start = res_usage();
+      m_timer.emplace(get_logger(), "capnp-raw", Timer::real_clock_types(), 100); // Begin timing.
+      m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
+      m_timer->checkpoint("sent request");
+
+      FLOW_LOG_WITH_CHECKING(m_sev, "< Expecting get-cache response header: capnp segment count; segment sizes.");
+      expect_response();
+    }
+
+    void expect_response()
+    {
+      /* The server sends the header in messages of up to send_blob_max_size() (same on both sides); the 1st one must
+       * fit whole.  (After the 1st response this doesn't reallocate: only the size changes.) */
+      m_hdr.resize(std::max(m_chan.send_blob_max_size() / sizeof(size_t), size_t(1)));
+      m_hdr_rcvd_sz = 0;
+      m_segs.clear();
+      m_rcv_state = Rcv_state::S_HDR;
+    }
+
+    // In the throughput phase there's no single RTT to time; so m_timer is null then.
+    void checkpoint(std::string&& name)
+    {
+      if (m_timer)
+      {
+        m_timer->checkpoint(std::move(name));
+      }
+    }
+
+    void on_hdr(size_t sz)
+    {
+      const bool first = m_hdr_rcvd_sz == 0;
+      m_hdr_rcvd_sz += sz;
+      if (first)
+      {
+        assert((m_hdr_rcvd_sz >= sizeof(size_t)) && "First in-message should begin with the capnp-segment count.");
+        m_n_segs = m_hdr.front();
+        assert(m_n_segs != 0);
+        // Now we know how much header there is; make room for the rest, if it didn't all fit in 1 message.
+        m_hdr.resize(std::max(m_hdr.size(), 1 + m_n_segs));
+      }
+      if (m_hdr_rcvd_sz != (1 + m_n_segs) * sizeof(size_t))
+      {
+        return; // More header messages to come.
+      }
+      // else
+
+      FLOW_LOG_WITH_CHECKING(m_sev, "= Got get-cache response header: capnp segment count = [" << m_n_segs << "].");
+      FLOW_LOG_WITH_CHECKING(m_sev, "< Expecting get-cache response fragments x N: [seg content...].");
+      checkpoint("got header");
+
+      m_segs.reserve(m_n_segs);
+      start_seg();
+      m_rcv_state = Rcv_state::S_SEG;
+    }
+
+    // Next segment's size known (from the header); reserve the space and then set .size() = 0, leaving .capacity().
+    void start_seg()
+    {
+      const auto seg_sz = m_hdr[1 + m_segs.size()];
+      assert(seg_sz != 0);
+
+      m_segs.emplace_back(seg_sz);
+      m_segs.back().clear();
+      assert(m_segs.back().capacity() == seg_sz); // Ensure it didn't dealloc.
+    }
+
     void on_complete_response()
     {
       /* Now for vanilla Cap'n Proto work: We have the segments; use SegmentArrayMessageReader as normal to
@@ -327,32 +1017,166 @@ void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
 
       const auto rsp_root = capnp_msg.getRoot<perf_demo::schema::Body>().getGetCacheRsp();
 
+      if (m_tput_phase)
+      {
+        return; // Just count it (in caller).  Its contents were verified in an earlier round.
+      }
+      // else
+
       m_timer->checkpoint("accessed deserialization root");
+      if (m_warm_up)
+      {
+        return; // Don't record it (see m_warm_up).  Verification happens in the 1st timed round (untimed there too).
+      }
+      // else
+
+      auto& result = g_results[m_result_idx];
+      result.m_capnp_over_raw_rtts.record(m_timer->since_start().m_values[size_t(Clock_type::S_REAL_HI_RES)]);
+      result.m_capnp_over_raw_usage += res_usage() - m_usage_start;
 
-      FLOW_LOG_INFO("= Done.  Total received size = "
-                    "[" << ceil_div(capnp_msg.sizeInWords() * sizeof(word), size_t(1024 * 1024)) << " Mi].  "
-                    "Will verify contents (sizes, hashes).");
+      /* Verifying hashes of the entire thing is slow (for large sizes); and it's the same data each time; so
+       * only do it on the 1st round for each size. */
+      if (m_iteration == 0)
+      {
+        FLOW_LOG_INFO("= Done.  Total received size = "
+                      "[" << ceil_div(capnp_msg.sizeInWords() * sizeof(word), size_t(1024)) << " Ki].  "
+                      "Will verify contents (sizes, hashes).");
 
-      verify_rsp(rsp_root);
+        verify_rsp(rsp_root, &result);
 
-      FLOW_LOG_INFO("= Contents look good.  Timing results: [\n" << m_timer.value() << "\n].");
-      g_capnp_over_raw_rtt = m_timer->since_start().m_values[size_t(Clock_type::S_REAL_HI_RES)];
+        FLOW_LOG_INFO("= Contents look good.  Timing results: [\n" << m_timer.value() << "\n].");
+      }
     } // on_complete_response()
-  }; // class Algo
-
-  Algo algo(logger_ptr, chan_ptr);
-  post(g_asio, [&]() { algo.start(); });
-  g_asio.run();
-  g_asio.restart();
-} // run_capnp_over_raw()
 
-void run_capnp_zero_cpy([[maybe_unused]] flow::log::Logger* logger_ptr, Channel_struc* chan_ptr)
-{
+    // Returns `true` if and only if there's more to receive (i.e., another response is in flight).
+    bool on_response_done()
+    {
+      if (m_tput_phase)
+      {
+        return on_tput_response_done();
+      }
+      // else
+      if (m_warm_up)
+      {
+        m_warm_up = false;
+        m_n_msgs = 0; // Count only the timed rounds (and the throughput phase) in msgs-per-wakeup.
+        m_n_wakeups = 0;
+        issue_request();
+        return true;
+      }
+      // else
+      if (++m_iteration != m_cfg.m_n_iterations)
+      {
+        issue_request();
+        return true;
+      }
+      // else
+      g_results[m_result_idx].m_capnp_over_raw_usage.m_shmem_rss_kib = res_usage(true).m_shmem_rss_kib; // (Untimed.)
+      if (m_cfg.m_tput_duration != flow::Fine_duration::zero())
+      {
+        start_tput();
+        return true;
+      }
+      // else
+      return next_size();
+    }
+
+    void start_tput()
+    {
+      using std::min;
+      using std::max;
+
+      m_tput_phase = true;
+      m_timer.reset();
+      m_sev = Sev::S_TRACE;
+
+      auto& tput = g_results[m_result_idx].m_capnp_over_raw_tput;
+      tput.m_window = max(min(m_cfg.m_tput_window, TPUT_MAX_BYTES_IN_FLIGHT / g_results[m_result_idx].m_req_sz),
+                          size_t(1));
+      FLOW_LOG_INFO("> Throughput phase: keeping [" << tput.m_window << "] get-cache requests in flight "
+                    "for [" << round<milliseconds>(m_cfg.m_tput_duration) << "].");
+
+      m_tput_start = flow::Fine_clock::now();
+      m_tput_end = m_tput_start + m_cfg.m_tput_duration;
+      for (size_t idx = 0; idx != tput.m_window; ++idx)
+      {
+        issue_tput_request();
+      }
+      expect_response();
+    }
+
+    void issue_tput_request()
+    {
+      m_n = g_results[m_result_idx].m_req_sz;
+      m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
+      ++m_n_in_flight;
+    }
+
+    bool on_tput_response_done()
+    {
+      auto& tput = g_results[m_result_idx].m_capnp_over_raw_tput;
+      ++tput.m_n_msgs;
+      --m_n_in_flight;
+
+      const auto now = flow::Fine_clock::now();
+      if (now < m_tput_end)
+      {
+        issue_tput_request(); // Keep the window full.
+      }
+      if (m_n_in_flight != 0)
+      {
+        expect_response();
+        return true;
+      }
+      // else: Drained.
+
+      tput.m_elapsed = now - m_tput_start;
+      FLOW_LOG_INFO("= Throughput phase done: [" << tput.m_n_msgs << "] responses "
+                    "in [" << round<milliseconds>(tput.m_elapsed) << "].");
+      return next_size();
+    }
+
+    // Returns `true` if and only if there's more to receive (i.e., another request was issued).
+    bool next_size()
+    {
+      auto& result = g_results[m_result_idx];
+      result.m_capnp_over_raw_n_msgs = m_n_msgs;
+      result.m_capnp_over_raw_n_wakeups = m_n_wakeups;
+      FLOW_LOG_INFO("= Received [" << m_n_msgs << "] messages for this size, waiting for readability "
+                    "[" << m_n_wakeups << "] times: "
+                    "[" << (double(m_n_msgs) / double(std::max(m_n_wakeups, uint64_t(1)))) << "] messages per wakeup.");
+
+      if (++m_result_idx != g_results.size())
+      {
+        start_size();
+        return true;
+      }
+      // else
+
+      // Tell server we're done: the special size 0.  Then we've no more async-ops; so g_asio.run() will return.
+      FLOW_LOG_INFO("> Issuing end-of-requests signal.");
+      m_n = 0;
+      m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
+      return false;
+    }
+  }; // class Algo
+
+  Algo algo(logger_ptr, chan_ptr, cfg);
+  post(g_asio, [&]() { algo.start(); });
+  run_g_asio(logger_ptr, cfg);
+  g_asio.restart();
+} // run_capnp_over_raw()
+
+void run_capnp_zero_cpy(flow::log::Logger* logger_ptr, Channel_struc* chan_ptr, const Bench_cfg& cfg)
+{
   using flow::Flow_log_component;
   using flow::log::Logger;
   using flow::log::Log_context;
+  using flow::log::Sev;
   using ::capnp::word;
   using boost::asio::post;
+  using boost::chrono::round;
+  using boost::chrono::milliseconds;
 
   // Reminder: see main_srv.cpp run_capnp_zero_cpy() counterpart; we keep comments light except for client-specifics.
 
@@ -360,13 +1184,29 @@ void run_capnp_zero_cpy([[maybe_unused]] flow::log::Logger* logger_ptr, Channel_
     public Log_context
   {
     Channel_struc& m_chan;
+    const Bench_cfg& m_cfg;
+    // Index into g_results of the response being requested/received currently; and which round for that size it is.
+    size_t m_result_idx = 0;
+    size_t m_iteration = 0;
+    // See run_capnp_over_raw() counterpart.
+    bool m_warm_up = false;
+    /* Throughput phase: as in run_capnp_over_raw(), except the responses are matched to requests by the channel for
+     * us, and we can send the same request message repeatedly (it is not consumed by sending), so we build it once. */
+    std::optional<Channel_struc::Msg_out> m_tput_req;
+    size_t m_n_in_flight = 0;
+    flow::Fine_time_pt m_tput_start;
+    flow::Fine_time_pt m_tput_end;
+    Sev m_sev = Sev::S_INFO;
     std::optional<Timer> m_timer;
+    Res_usage m_usage_start;
 
-    Algo(Logger* logger_ptr, Channel_struc* chan_ptr) :
+    Algo(Logger* logger_ptr, Channel_struc* chan_ptr, const Bench_cfg& cfg) :
       Log_context(logger_ptr, Flow_log_component::S_UNCAT),
-      m_chan(*chan_ptr)      
+      m_chan(*chan_ptr),
+      m_cfg(cfg)
     {
-      FLOW_LOG_INFO("-- RUN - zero-copy (SHM-backed) capnp request/response using Flow-IPC --");
+      FLOW_LOG_INFO("-- RUN - " << serialize_desc(m_cfg.m_serialize_via)
+                    << " capnp request/response using Flow-IPC --");
     }
 
     void start()
@@ -385,13 +1225,37 @@ void run_capnp_zero_cpy([[maybe_unused]] flow::log::Logger* logger_ptr, Channel_
 
     void on_sync()
     {
-      // Send a dummy message as a request signal, so we can start timing RTT before sending it.
       FLOW_LOG_INFO("= Got handshake SYN.");
+      start_size();
+    }
 
+    void start_size()
+    {
+      m_iteration = 0;
+      m_warm_up = true;
+      issue_request();
+    }
+
+    Channel_struc::Msg_out create_request()
+    {
+      // Send a request with the size (same sizes as learned in run_capnp_over_raw()).
       auto req = m_chan.create_msg();
-      req.body_root()->initGetCacheReq().setFileName("file.bin");
+      auto req_root = req.body_root()->initGetCacheReq();
+      req_root.setFileName("file.bin");
+      req_root.setFileSz(g_results[m_result_idx].m_req_sz);
+      return req;
+    }
 
-      FLOW_LOG_INFO("> Issuing get-cache request: [" << req << "].");
+    void issue_request()
+    {
+      // Start timing RTT before sending the request.
+      auto req = create_request();
+
+      m_sev = (m_iteration == 0) ? Sev::S_INFO : Sev::S_TRACE;
+      FLOW_LOG_WITH_CHECKING(m_sev, "> Issuing get-cache request: [" << req << "]; "
+                                    "round [" << (m_iteration + 1) << '/' << m_cfg.m_n_iterations << "]"
+                                    << (m_warm_up ? ", untimed warm-up" : "") << '.');
+      m_usage_start = res_usage();
       m_timer.emplace(get_logger(), "capnp-flow-ipc-e2e-zero-copy", Timer::real_clock_types(), 100);
 
       m_chan.async_request(req, nullptr, nullptr,
@@ -404,28 +1268,619 @@ void run_capnp_zero_cpy([[maybe_unused]] flow::log::Logger* logger_ptr, Channel_
       const auto rsp_root = rsp->body_root().getGetCacheRsp();
 
       m_timer->checkpoint("accessed deserialization root");
+      if (m_warm_up)
+      {
+        // As in run_capnp_over_raw(): don't record it.
+        rsp.reset();
+        m_warm_up = false;
+        issue_request();
+        return;
+      }
+      // else
+
+      auto& result = g_results[m_result_idx];
+      result.m_capnp_zero_cpy_rtts.record(m_timer->since_start().m_values[size_t(Clock_type::S_REAL_HI_RES)]);
+      result.m_capnp_zero_cpy_usage += res_usage() - m_usage_start;
+
+      // As in run_capnp_over_raw(): verify only on the 1st round for each size.
+      if (m_iteration == 0)
+      {
+        FLOW_LOG_INFO("= Done.  Will verify contents (sizes, hashes).");
+
+        verify_rsp(rsp_root, &result);
+
+        FLOW_LOG_INFO("= Contents look good.  Timing results: [\n" << m_timer.value() << "\n].");
+      }
+
+      rsp.reset();
+
+      /* Unlike in run_capnp_over_raw() there's no recursion danger here: the response to an async_request() is
+       * never available synchronously. */
+      if (++m_iteration != m_cfg.m_n_iterations)
+      {
+        issue_request();
+        return;
+      }
+      // else
+      result.m_capnp_zero_cpy_usage.m_shmem_rss_kib = res_usage(true).m_shmem_rss_kib; // (Untimed.)
+      if (m_cfg.m_tput_duration != flow::Fine_duration::zero())
+      {
+        start_tput();
+        return;
+      }
+      // else
+      next_size();
+    } // on_complete_response()
+
+    void start_tput()
+    {
+      m_timer.reset();
+      m_tput_req.emplace(create_request());
 
-      FLOW_LOG_INFO("= Done.  Will verify contents (sizes, hashes).");
+      auto& tput = g_results[m_result_idx].m_capnp_zero_cpy_tput;
+      tput.m_window = m_cfg.m_tput_window;
+      FLOW_LOG_INFO("> Throughput phase: keeping [" << tput.m_window << "] get-cache requests in flight "
+                    "for [" << round<milliseconds>(m_cfg.m_tput_duration) << "].");
 
-      verify_rsp(rsp_root);
+      m_tput_start = flow::Fine_clock::now();
+      m_tput_end = m_tput_start + m_cfg.m_tput_duration;
+      for (size_t idx = 0; idx != tput.m_window; ++idx)
+      {
+        issue_tput_request();
+      }
+    }
 
-      FLOW_LOG_INFO("= Contents look good.  Timing results: [\n" << m_timer.value() << "\n].");
-      g_capnp_zero_cpy_rtt = m_timer->since_start().m_values[size_t(Clock_type::S_REAL_HI_RES)];
+    void issue_tput_request()
+    {
+      m_chan.async_request(*m_tput_req, nullptr, nullptr,
+                           [&](Channel_struc::Msg_in_ptr&& rsp) { on_tput_response(std::move(rsp)); });
+      ++m_n_in_flight;
+    }
 
+    void on_tput_response(Channel_struc::Msg_in_ptr&& rsp)
+    {
+      // Access it, as a real user would; but its contents were verified in an earlier round.
+      [[maybe_unused]] const auto rsp_root = rsp->body_root().getGetCacheRsp();
       rsp.reset();
+
+      auto& tput = g_results[m_result_idx].m_capnp_zero_cpy_tput;
+      ++tput.m_n_msgs;
+      --m_n_in_flight;
+
+      const auto now = flow::Fine_clock::now();
+      if (now < m_tput_end)
+      {
+        issue_tput_request(); // Keep the window full.
+      }
+      if (m_n_in_flight != 0)
+      {
+        return;
+      }
+      // else: Drained.
+
+      tput.m_elapsed = now - m_tput_start;
+      FLOW_LOG_INFO("= Throughput phase done: [" << tput.m_n_msgs << "] responses "
+                    "in [" << round<milliseconds>(tput.m_elapsed) << "].");
+      m_tput_req.reset();
+      next_size();
+    }
+
+    void next_size()
+    {
+      if (++m_result_idx != g_results.size())
+      {
+        start_size();
+        return;
+      }
+      // else
+
+      // Tell server we're done: the special size 0.
+      FLOW_LOG_INFO("> Issuing end-of-requests signal.");
+      auto req = m_chan.create_msg();
+      req.body_root()->initGetCacheReq().setFileSz(0);
+      m_chan.send(req);
+
       g_asio.stop();
-    } // on_complete_response()
+    }
   }; // class Algo
 
-  Algo algo(logger_ptr, chan_ptr);
+  Algo algo(logger_ptr, chan_ptr, cfg);
   post(g_asio, [&]() { algo.start(); });
-  g_asio.run();
+  run_g_asio(logger_ptr, cfg);
   g_asio.restart();
   g_asio.poll();
   g_asio.restart();
 } // run_capnp_zero_cpy()
 
-void verify_rsp(const perf_demo::schema::GetCacheRsp::Reader& rsp_root)
+void run_io_overhead(flow::log::Logger* logger_ptr, Channel_raw* raw_sio_ptr, Channel_raw_aio* raw_aio_ptr,
+                     Channel_struc* struc_sio_ptr, Channel_struc_aio* struc_aio_ptr, const Bench_cfg& cfg)
+{
+  using flow::Flow_log_component;
+  using flow::log::Logger;
+  using flow::log::Log_context;
+  using boost::asio::post;
+
+  /* Reminder: see main_srv.cpp run_io_overhead() counterpart.  For each Io_variant in turn: send a tiny request,
+   * await the echo, repeat; then send the end-of-variant signal (0).  We time each round trip; and count the context
+   * switches (getrusage()) over all of them.  The async-I/O handlers are invoked from thread W; and we post() the rest
+   * of the work onto g_asio, as one normally would; that's precisely the overhead (1 or 2 context switches, and the
+   * signaling) in question.  Nothing is logged during the round trips, of course. */
+
+  struct Algo :
+    public Log_context
+  {
+    Channel_raw& m_raw_sio;
+    Channel_raw_aio& m_raw_aio;
+    Channel_struc& m_struc_sio;
+    Channel_struc_aio& m_struc_aio;
+    const Bench_cfg& m_cfg;
+    // The struc::Channel variants' request: always the same; it can be sent repeatedly.
+    std::optional<Channel_struc::Msg_out> m_struc_sio_req;
+    std::optional<Channel_struc_aio::Msg_out> m_struc_aio_req;
+    Error_code m_err_code;
+    size_t m_sz;
+    // The raw variants' request; and where the echo lands.
+    size_t m_n = 0;
+    Io_variant m_variant = Io_variant::S_RAW_SYNC_IO;
+    size_t m_round = 0;
+    flow::Fine_time_pt m_ping_time;
+    Ctx_switches m_ctx_switches_start;
+
+    Algo(Logger* logger_ptr, Channel_raw* raw_sio_ptr, Channel_raw_aio* raw_aio_ptr,
+         Channel_struc* struc_sio_ptr, Channel_struc_aio* struc_aio_ptr, const Bench_cfg& cfg) :
+      Log_context(logger_ptr, Flow_log_component::S_UNCAT),
+      m_raw_sio(*raw_sio_ptr),
+      m_raw_aio(*raw_aio_ptr),
+      m_struc_sio(*struc_sio_ptr),
+      m_struc_aio(*struc_aio_ptr),
+      m_cfg(cfg)
+    {
+      FLOW_LOG_INFO("-- RUN - sync_io versus async-I/O overhead: tiny request/response, "
+                    "[" << m_cfg.m_io_overhead_rounds << "] round trips each way --");
+
+      m_struc_sio_req.emplace(m_struc_sio.create_msg());
+      m_struc_sio_req->body_root()->initGetCacheReq().setFileSz(1); // Anything but 0 (end-of-variant signal).
+      m_struc_aio_req.emplace(m_struc_aio.create_msg());
+      m_struc_aio_req->body_root()->initGetCacheReq().setFileSz(1);
+    }
+
+    void start()
+    {
+      m_raw_sio.replace_event_wait_handles([]() -> auto { return Asio_handle(g_asio); });
+      m_raw_sio.start_send_blob_ops(ev_wait);
+      m_raw_sio.start_receive_blob_ops(ev_wait);
+      m_struc_sio.replace_event_wait_handles([]() -> auto { return Asio_handle(g_asio); });
+      m_struc_sio.start_ops(ev_wait);
+      m_struc_sio.start_and_poll([](const Error_code&) {});
+      m_struc_aio.start([](const Error_code&) {});
+
+      start_variant(Io_variant::S_RAW_SYNC_IO);
+    }
+
+    void start_variant(Io_variant variant)
+    {
+      m_variant = variant;
+      m_round = 0;
+      FLOW_LOG_INFO("> [" << io_variant_desc(m_variant) << "]: Issuing requests.");
+
+      m_ctx_switches_start = ctx_switches();
+      switch (m_variant)
+      {
+      case Io_variant::S_RAW_SYNC_IO:
+        ping_raw_sio();
+        break;
+      case Io_variant::S_RAW_ASYNC_IO:
+        ping_raw_aio();
+        break;
+      case Io_variant::S_STRUC_SYNC_IO:
+        ping_struc_sio();
+        break;
+      case Io_variant::S_STRUC_ASYNC_IO:
+        ping_struc_aio();
+      }
+    }
+
+    // Same looping-not-recursing technique as in run_capnp_over_raw(): the echo may be available synchronously.
+    void ping_raw_sio()
+    {
+      do
+      {
+        m_ping_time = flow::Fine_clock::now();
+        m_n = m_round + 1;
+        m_raw_sio.send_blob(Blob_const(&m_n, sizeof(m_n)));
+        m_raw_sio.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), &m_err_code, &m_sz,
+                                     [this](const Error_code& err_code, size_t)
+        {
+          if (on_pong(err_code))
+          {
+            ping_raw_sio();
+          }
+        });
+        if (m_err_code == ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { return; }
+      }
+      while (on_pong(m_err_code));
+    }
+
+    void ping_raw_aio()
+    {
+      m_ping_time = flow::Fine_clock::now();
+      m_n = m_round + 1;
+      m_raw_aio.send_blob(Blob_const(&m_n, sizeof(m_n)));
+      m_raw_aio.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), [this](const Error_code& err_code, size_t)
+      {
+        if (err_code == ipc::transport::error::Code::S_OBJECT_SHUTDOWN_ABORTED_COMPLETION_HANDLER)
+        {
+          return;
+        }
+        // else
+        post(g_asio, [this, err_code]()
+        {
+          if (on_pong(err_code))
+          {
+            ping_raw_aio();
+          }
+        });
+      });
+    }
+
+    // (The response to an async_request() is never available synchronously; so no recursion worries here.)
+    void ping_struc_sio()
+    {
+      m_ping_time = flow::Fine_clock::now();
+      m_struc_sio.async_request(*m_struc_sio_req, nullptr, nullptr, [this](Channel_struc::Msg_in_ptr&& rsp)
+      {
+        // Access it, as a real user would.
+        [[maybe_unused]] const auto rsp_root = rsp->body_root().getGetCacheRsp();
+        rsp.reset();
+        if (on_pong(Error_code()))
+        {
+          ping_struc_sio();
+        }
+      });
+    }
+
+    void ping_struc_aio()
+    {
+      m_ping_time = flow::Fine_clock::now();
+      m_struc_aio.async_request(*m_struc_aio_req, nullptr, nullptr, [this](Channel_struc_aio::Msg_in_ptr&& rsp)
+      {
+        post(g_asio, [this, rsp = std::move(rsp)]() mutable
+        {
+          [[maybe_unused]] const auto rsp_root = rsp->body_root().getGetCacheRsp();
+          rsp.reset();
+          if (on_pong(Error_code()))
+          {
+            ping_struc_aio();
+          }
+        });
+      });
+    }
+
+    // Returns `true` if and only if the current variant has another round to go (which the caller shall issue).
+    bool on_pong(const Error_code& err_code)
+    {
+      if (err_code) { throw Runtime_error(err_code, "run_io_overhead():on_pong()"); }
+
+      auto& result = g_io_overhead[size_t(m_variant)];
+      result.m_rtts.record(flow::Fine_clock::now() - m_ping_time);
+      if (++m_round != m_cfg.m_io_overhead_rounds)
+      {
+        return true;
+      }
+      // else
+
+      const auto now = ctx_switches();
+      result.m_ctx_switches.m_voluntary += now.m_voluntary - m_ctx_switches_start.m_voluntary;
+      result.m_ctx_switches.m_involuntary += now.m_involuntary - m_ctx_switches_start.m_involuntary;
+      FLOW_LOG_INFO("= [" << io_variant_desc(m_variant) << "]: Done.  Issuing end-of-variant signal.");
+      end_variant();
+      return false;
+    }
+
+    void end_variant()
+    {
+      // Tell server we're done with this variant: the special request 0.
+      m_n = 0;
+      switch (m_variant)
+      {
+      case Io_variant::S_RAW_SYNC_IO:
+        m_raw_sio.send_blob(Blob_const(&m_n, sizeof(m_n)));
+        start_variant(Io_variant::S_RAW_ASYNC_IO);
+        return;
+      case Io_variant::S_RAW_ASYNC_IO:
+        m_raw_aio.send_blob(Blob_const(&m_n, sizeof(m_n)));
+        start_variant(Io_variant::S_STRUC_SYNC_IO);
+        return;
+      case Io_variant::S_STRUC_SYNC_IO:
+      {
+        auto req = m_struc_sio.create_msg();
+        req.body_root()->initGetCacheReq().setFileSz(0);
+        m_struc_sio.send(req);
+        start_variant(Io_variant::S_STRUC_ASYNC_IO);
+        return;
+      }
+      case Io_variant::S_STRUC_ASYNC_IO:
+      {
+        auto req = m_struc_aio.create_msg();
+        req.body_root()->initGetCacheReq().setFileSz(0);
+        m_struc_aio.send(req);
+        /* The sync_io struc::Channel always has an .async_wait() outstanding; so g_asio.run() would never return
+         * by itself.  (Conversely, without it, it would return during the async-I/O variants, while we wait for
+         * thread W's post().)  See also run_capnp_zero_cpy(). */
+        g_asio.stop();
+      }
+      }
+    } // end_variant()
+  }; // class Algo
+
+  for (auto& result : g_io_overhead)
+  {
+    result = Io_overhead_result();
+  }
+  Algo algo(logger_ptr, raw_sio_ptr, raw_aio_ptr, struc_sio_ptr, struc_aio_ptr, cfg);
+  post(g_asio, [&]() { algo.start(); });
+  run_g_asio(logger_ptr, cfg);
+  g_asio.restart();
+  g_asio.poll();
+  g_asio.restart();
+} // run_io_overhead()
+
+void run_ping_pong(flow::log::Logger* logger_ptr, Channel_raw* raw_ptr, Channel_struc* struc_ptr,
+                   const Bench_cfg& cfg)
+{
+  using flow::Flow_log_component;
+  using flow::log::Logger;
+  using flow::log::Log_context;
+  using boost::asio::post;
+
+  /* Reminder: see main_srv.cpp run_ping_pong() counterpart.  For each channel (raw, then structured), for each of
+   * PING_PONG_SZS that it can carry: send a blob of that size, await the echo, repeat: N (--ping-pong=N) times, timing
+   * each round trip; half of that is the one-way latency.  Then N more, but keeping up to --window of them in flight
+   * (pipelined): that's the message rate.  Then the next size.  Then the end-of-pings signal for that channel.
+   *
+   * As everywhere else here: the sync_io API; 1 thread on each side; nothing logged during the timed parts. */
+
+  struct Algo :
+    public Log_context
+  {
+    Channel_raw& m_raw;
+    Channel_struc& m_struc;
+    const Bench_cfg& m_cfg;
+    // Raw requests are a prefix of this; the echo lands in m_raw_rsp.
+    Blob m_raw_req;
+    Blob m_raw_rsp;
+    // Structured requests: key = blob size.  Each one can be sent repeatedly (and be in flight more than once).
+    std::map<size_t, Channel_struc::Msg_out> m_struc_reqs;
+    Error_code m_err_code;
+    size_t m_sz;
+    // Where we are: which channel; which size (index into PING_PONG_SZS); which phase of it; how far.
+    bool m_struc_else_raw = false;
+    size_t m_sz_idx = 0;
+    bool m_tput_else_rtt = false;
+    size_t m_n_sent = 0;
+    size_t m_n_rcvd = 0;
+    flow::Fine_time_pt m_ping_time;
+    flow::Fine_time_pt m_tput_start;
+
+    Algo(Logger* logger_ptr, Channel_raw* raw_ptr, Channel_struc* struc_ptr, const Bench_cfg& cfg) :
+      Log_context(logger_ptr, Flow_log_component::S_UNCAT),
+      m_raw(*raw_ptr),
+      m_struc(*struc_ptr),
+      m_cfg(cfg),
+      m_raw_req(PING_PONG_SZS.back()),
+      m_raw_rsp(PING_PONG_SZS.back())
+    {
+      FLOW_LOG_INFO("-- RUN - small-message ping-pong, [" << m_cfg.m_ping_pong_rounds << "] round trips per size; "
+                    "then as many pipelined, up to [" << m_cfg.m_tput_window << "] in flight --");
+
+      std::fill(m_raw_req.begin(), m_raw_req.end(), uint8_t(1));
+      for (const auto sz : PING_PONG_SZS)
+      {
+        if (ping_pong_sz_ok(sz, true, m_raw.send_blob_max_size()))
+        {
+          auto& req = m_struc_reqs.emplace(sz, m_struc.create_msg()).first->second;
+          auto data = req.body_root()->initPingPong(sz);
+          std::fill(data.begin(), data.end(), uint8_t(1));
+        }
+      }
+    }
+
+    void start()
+    {
+      m_raw.replace_event_wait_handles([]() -> auto { return Asio_handle(g_asio); });
+      m_raw.start_send_blob_ops(ev_wait);
+      m_raw.start_receive_blob_ops(ev_wait);
+      m_struc.replace_event_wait_handles([]() -> auto { return Asio_handle(g_asio); });
+      m_struc.start_ops(ev_wait);
+      m_struc.start_and_poll([](const Error_code&) {});
+
+      if (start_size())
+      {
+        read_raw();
+      }
+    }
+
+    std::string chan_desc() const
+    {
+      return m_struc_else_raw ? "structured" : "raw";
+    }
+
+    /* Begins the next size (from m_sz_idx on) that the current channel can carry.  If none: signals the end to
+     * the server; and moves on to the structured channel (or, if that was it, stops g_asio).  Returns `true` if and
+     * only if it began a size on the raw channel (so a raw pong shall be expected). */
+    bool start_size()
+    {
+      for (; m_sz_idx != PING_PONG_SZS.size(); ++m_sz_idx)
+      {
+        const auto sz = PING_PONG_SZS[m_sz_idx];
+        if (ping_pong_sz_ok(sz, m_struc_else_raw, m_raw.send_blob_max_size()))
+        {
+          FLOW_LOG_INFO("> [" << chan_desc() << "], [" << sz << "]-byte blobs: Pinging.");
+          g_ping_pong[size_t(m_struc_else_raw)][m_sz_idx].m_ok = true;
+          m_tput_else_rtt = false;
+          m_n_sent = 0;
+          m_n_rcvd = 0;
+          ping();
+          return !m_struc_else_raw;
+        }
+        // else
+        FLOW_LOG_INFO("= [" << chan_desc() << "], [" << sz << "]-byte blobs: Skipping: too large for this channel.");
+      }
+      // else
+
+      FLOW_LOG_INFO("= [" << chan_desc() << "]: Done.  Issuing end-of-pings signal.");
+      if (!m_struc_else_raw)
+      {
+        const std::array<uint8_t, PING_PONG_END_SZ> end{};
+        m_raw.send_blob(Blob_const(end.data(), end.size())); // The special end-of-pings ping.
+        m_struc_else_raw = true;
+        m_sz_idx = 0;
+        start_size();
+        return false;
+      }
+      // else
+      auto req = m_struc.create_msg();
+      req.body_root()->initPingPong(PING_PONG_END_SZ); // Ditto.
+      m_struc.send(req);
+      g_asio.stop(); // See run_io_overhead() for why.
+      return false;
+    }
+
+    void ping()
+    {
+      const auto sz = PING_PONG_SZS[m_sz_idx];
+      ++m_n_sent;
+      m_ping_time = flow::Fine_clock::now();
+      if (!m_struc_else_raw)
+      {
+        m_raw.send_blob(Blob_const(m_raw_req.const_data(), sz));
+        return;
+      }
+      // else
+
+      // (The response to an async_request() is never available synchronously; so no recursion worries here.)
+      m_struc.async_request(m_struc_reqs.find(sz)->second, nullptr, nullptr,
+                            [this, sz](Channel_struc::Msg_in_ptr&& rsp)
+      {
+        // Access it, as a real user would.
+        if (rsp->body_root().getPingPong().size() != sz)
+        {
+          throw Runtime_error("Pong size does not match ping size!");
+        }
+        rsp.reset();
+        on_pong();
+      });
+    }
+
+    // Same looping-not-recursing technique as in run_capnp_over_raw(): the echo may be available synchronously.
+    void read_raw()
+    {
+      do
+      {
+        m_raw.async_receive_blob(Blob_mutable(m_raw_rsp.data(), m_raw_rsp.size()), &m_err_code, &m_sz,
+                                 [this](const Error_code& err_code, size_t sz)
+        {
+          if (on_raw_pong(err_code, sz))
+          {
+            read_raw();
+          }
+        });
+        if (m_err_code == ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { return; }
+      }
+      while (on_raw_pong(m_err_code, m_sz));
+    }
+
+    bool on_raw_pong(const Error_code& err_code, size_t sz)
+    {
+      if (err_code) { throw Runtime_error(err_code, "run_ping_pong():on_raw_pong()"); }
+      if (sz != PING_PONG_SZS[m_sz_idx])
+      {
+        throw Runtime_error("Pong size does not match ping size!");
+      }
+      // else
+      return on_pong();
+    }
+
+    /* Issues the next ping(s), if any, as the phase requires; otherwise moves on to the next size.  Returns `true` if
+     * and only if a raw pong shall be expected next (for the structured channel: meaningless). */
+    bool on_pong()
+    {
+      const auto now = flow::Fine_clock::now();
+      const auto n_rounds = m_cfg.m_ping_pong_rounds;
+      auto& result = g_ping_pong[size_t(m_struc_else_raw)][m_sz_idx];
+
+      ++m_n_rcvd;
+      if (!m_tput_else_rtt)
+      {
+        result.m_one_way.record((now - m_ping_time) / 2);
+        if (m_n_rcvd != n_rounds)
+        {
+          ping();
+          return true;
+        }
+        // else: Same number again, pipelined.
+        m_tput_else_rtt = true;
+        m_n_sent = 0;
+        m_n_rcvd = 0;
+        result.m_tput.m_window = std::min(m_cfg.m_tput_window, n_rounds);
+        m_tput_start = now;
+        while (m_n_sent != result.m_tput.m_window)
+        {
+          ping();
+        }
+        return true;
+      }
+      // else
+
+      if (m_n_rcvd != n_rounds)
+      {
+        if (m_n_sent != n_rounds)
+        {
+          ping();
+        }
+        return true;
+      }
+      // else
+      result.m_tput.m_n_msgs = n_rounds;
+      result.m_tput.m_elapsed = now - m_tput_start;
+
+      ++m_sz_idx;
+      return start_size();
+    } // on_pong()
+  }; // class Algo
+
+  for (auto& results : g_ping_pong)
+  {
+    for (auto& result : results)
+    {
+      result = Ping_pong_result();
+    }
+  }
+  Algo algo(logger_ptr, raw_ptr, struc_ptr, cfg);
+  post(g_asio, [&]() { algo.start(); });
+  run_g_asio(logger_ptr, cfg);
+  g_asio.restart();
+  g_asio.poll();
+  g_asio.restart();
+} // run_ping_pong()
+
+void run_g_asio(flow::log::Logger* logger_ptr, const Bench_cfg& cfg)
+{
+  using flow::Flow_log_component;
+
+  FLOW_LOG_SET_CONTEXT(logger_ptr, Flow_log_component::S_UNCAT);
+
+  Busy_poll_stats stats;
+  run_event_loop(&g_asio, cfg.m_busy_poll, &stats);
+  if (cfg.m_busy_poll != flow::Fine_duration::zero())
+  {
+    FLOW_LOG_INFO("Busy-poll (up to [" << boost::chrono::round<boost::chrono::microseconds>(cfg.m_busy_poll) << "] "
+                  "when idle): work found while spinning [" << stats.m_spin_hits << "] times; "
+                  "went to sleep [" << stats.m_fallbacks << "] times.");
+  }
+}
+
+void verify_rsp(const perf_demo::schema::GetCacheRsp::Reader& rsp_root, Result* result)
 {
   using flow::util::String_view;
 
@@ -454,9 +1909,533 @@ void verify_rsp(const perf_demo::schema::GetCacheRsp::Reader& rsp_root)
     total_sz += data.size();
   }
 
-  if ((g_total_sz != 0) && (total_sz != g_total_sz))
+  if ((result->m_total_sz != 0) && (total_sz != result->m_total_sz))
   {
     throw Runtime_error("Total rough data sizes between different runs do not match!");
   }
-  g_total_sz = total_sz;
+  result->m_total_sz = total_sz;
 }
+
+void log_summary(flow::log::Logger* logger_ptr, const Bench_cfg& cfg)
+{
+  using flow::Flow_log_component;
+  using flow::util::String_view;
+  using flow::util::ceil_div;
+  using boost::chrono::microseconds;
+  using boost::chrono::round;
+  using std::setw;
+  using std::setprecision;
+  using std::fixed;
+
+  FLOW_LOG_SET_CONTEXT(logger_ptr, Flow_log_component::S_UNCAT);
+
+  /* They already printed detailed timing info; now let's summarize the total results.  As you can see it
+   * just prints b1's RTT, b2's RTT, and the ratio; while reminding how much data was transmitted.
+   * (Ultimately b2's RTT will always be about the same and small; whereas b1's involves a bunch of copying
+   * into/out of tranport and hence will be proportional to data size.)
+   *
+   * In the usual case of 1 size: the only subtlety is that we coarsen the RTT to be a multiple of 100us, rounding up.
+   * Reason: It's not bulletproof, and it might be different on slower machines, but for now I've found this to be
+   * decent in practice: There's quite a bit of variation for a small message's RTT, maybe +/- 50us; and the total
+   * tends to be, if rounded to nearest 100us, at least 100us.  Furthermore, if sending small messages, sometimes there
+   * are paradoxical-ish results like b1-RTT/b2-RTT < 1, but really they're both around 100us, so it's more like 1.
+   * Once total_sz is increased beyond 10k-or-so, this stuff falls away and the coarsening to 100us-multiples
+   * doesn't really matter anyway and is easier to read.
+   *
+   * Maybe that's silliness.  In any case the un-coarsened detailed results are printed by run_*(); here
+   * we're summarizing.  @todo Revisit.
+   *
+   * In sweep mode (2+ sizes) the whole point is to see where the small sizes stop and the big sizes begin, so
+   * there we print the un-coarsened RTTs as a table instead; plus the crossover point.
+   *
+   * With --iterations=N > 1 "the RTT" is the median of the N rounds (and the coarsening is skipped: the median of many
+   * rounds is not so noisy); but first we print the whole distribution of each.
+   *
+   * With --throughput-secs we also print the sustained rate with the pipelined window of requests in flight.  Since
+   * raw's RTT grows with size, while zero-copy's does not, one would expect the same story there; but
+   * pipelining hides some of the latency, so it's worth seeing by how much.
+   *
+   * With --io-overhead we also print that benchmark's results: these are tiny messages, so RTTs are in the usec range
+   * or lower; hence we print fractions of usec there.
+   *
+   * Either way we print the OS resource usage per round (see Res_usage), as that tends to explain the RTTs: raw's
+   * grow with the bytes copied and the read()s/write()s; zero-copy's first-touch page faults (if any) show up there
+   * too; and context switches explain the small-size noise. */
+
+  const auto zcp_desc = serialize_desc(cfg.m_serialize_via);
+
+  const auto to_usec = [](flow::Fine_duration dur) -> auto { return round<microseconds>(dur).count(); };
+  const auto to_usec_f = [](flow::Fine_duration dur) -> double
+  {
+    return boost::chrono::duration<double, boost::micro>(dur).count();
+  };
+
+  if (cfg.m_n_iterations != 1)
+  {
+    FLOW_LOG_INFO("Latency distribution over [" << cfg.m_n_iterations << "] request/response rounds per size; "
+                  "RTTs in usec; CV = coefficient of variation (stddev / mean): ");
+    FLOW_LOG_INFO(setw(12) << "size (ki)" << " | " << setw(10) << "transport" << " | "
+                  << setw(8) << "p50" << " | " << setw(8) << "p90" << " | " << setw(8) << "p99" << " | "
+                  << setw(8) << "p99.9" << " | " << setw(8) << "max" << " | " << setw(6) << "CV");
+    for (const auto& result : g_results)
+    {
+      for (const auto raw_else_zcp : { true, false })
+      {
+        const auto& rtts = raw_else_zcp ? result.m_capnp_over_raw_rtts : result.m_capnp_zero_cpy_rtts;
+        FLOW_LOG_INFO(setw(12) << (result.m_total_sz / 1024) << " | "
+                      << setw(10) << (raw_else_zcp ? "raw" : "zero-copy") << " | "
+                      << setw(8) << to_usec(rtts.percentile(50)) << " | "
+                      << setw(8) << to_usec(rtts.percentile(90)) << " | "
+                      << setw(8) << to_usec(rtts.percentile(99)) << " | "
+                      << setw(8) << to_usec(rtts.percentile(99.9)) << " | "
+                      << setw(8) << to_usec(rtts.max()) << " | "
+                      << setw(6) << fixed << setprecision(3) << rtts.coeff_of_variation());
+      }
+    }
+  }
+
+  if (cfg.m_tput_duration != flow::Fine_duration::zero())
+  {
+    FLOW_LOG_INFO("Sustained throughput with up to [" << cfg.m_tput_window << "] requests in flight "
+                  "(window may be lower for raw at large sizes, to bound memory use): ");
+    FLOW_LOG_INFO(setw(12) << "size (ki)" << " | " << setw(10) << "transport" << " | " << setw(6) << "window" << " | "
+                  << setw(12) << "msgs/sec" << " | " << setw(10) << "GiB/sec");
+    for (const auto& result : g_results)
+    {
+      for (const auto raw_else_zcp : { true, false })
+      {
+        const auto& tput = raw_else_zcp ? result.m_capnp_over_raw_tput : result.m_capnp_zero_cpy_tput;
+        const double secs = boost::chrono::duration<double>(tput.m_elapsed).count();
+        const double msgs_per_sec = (secs == 0) ? 0 : (double(tput.m_n_msgs) / secs);
+        FLOW_LOG_INFO(setw(12) << (result.m_total_sz / 1024) << " | "
+                      << setw(10) << (raw_else_zcp ? "raw" : "zero-copy") << " | "
+                      << setw(6) << tput.m_window << " | "
+                      << setw(12) << fixed << setprecision(0) << msgs_per_sec << " | "
+                      << setw(10) << fixed << setprecision(3)
+                      << (msgs_per_sec * double(result.m_total_sz) / double(1024 * 1024 * 1024)));
+      }
+    }
+  }
+
+  FLOW_LOG_INFO("OS resource usage per round (this process, all threads; timed part only), next to the median RTT: ");
+  for (const auto& result : g_results)
+  {
+    for (const auto raw_else_zcp : { true, false })
+    {
+      const auto& rtts = raw_else_zcp ? result.m_capnp_over_raw_rtts : result.m_capnp_zero_cpy_rtts;
+      const auto& usage = raw_else_zcp ? result.m_capnp_over_raw_usage : result.m_capnp_zero_cpy_usage;
+      FLOW_LOG_INFO(setw(12) << (result.m_total_sz / 1024) << " ki | " << setw(10)
+                    << (raw_else_zcp ? "raw" : "zero-copy") << " | " << setw(8) << to_usec(rtts.percentile(50))
+                    << " usec | " << res_usage_desc(usage, rtts.count()));
+    }
+  }
+
+  if (cfg.m_io_overhead_rounds != 0)
+  {
+    const auto per_rtt = [](uint64_t n, const Io_overhead_result& result) -> double
+    {
+      return (result.m_rtts.count() == 0) ? 0 : (double(n) / double(result.m_rtts.count()));
+    };
+
+    FLOW_LOG_INFO("sync_io versus async-I/O overhead: tiny request/response over [" << transport_desc() << "]; "
+                  "[" << g_io_overhead.front().m_rtts.count() << "] round trips each way; RTTs in usec; "
+                  "context switches (this process, all threads) per round trip: ");
+    FLOW_LOG_INFO(setw(26) << "way" << " | " << setw(8) << "p50" << " | " << setw(8) << "p99" << " | "
+                  << setw(8) << "mean" << " | " << setw(10) << "vol. csw" << " | " << setw(10) << "invol. csw");
+    for (size_t idx = 0; idx != N_IO_VARIANTS; ++idx)
+    {
+      const auto& result = g_io_overhead[idx];
+      FLOW_LOG_INFO(setw(26) << io_variant_desc(Io_variant(idx)) << " | " << fixed << setprecision(2)
+                    << setw(8) << to_usec_f(result.m_rtts.percentile(50)) << " | "
+                    << setw(8) << to_usec_f(result.m_rtts.percentile(99)) << " | "
+                    << setw(8) << to_usec_f(result.m_rtts.mean()) << " | "
+                    << setw(10) << per_rtt(result.m_ctx_switches.m_voluntary, result) << " | "
+                    << setw(10) << per_rtt(result.m_ctx_switches.m_involuntary, result));
+    }
+    const auto p50_delta = [&](Io_variant sio, Io_variant aio) -> double
+    {
+      return to_usec_f(g_io_overhead[size_t(aio)].m_rtts.percentile(50))
+               - to_usec_f(g_io_overhead[size_t(sio)].m_rtts.percentile(50));
+    };
+    FLOW_LOG_INFO("async-I/O overhead (median RTT, minus sync_io's): "
+                  "raw Channel: [" << fixed << setprecision(2)
+                  << p50_delta(Io_variant::S_RAW_SYNC_IO, Io_variant::S_RAW_ASYNC_IO) << " usec]; "
+                  "struc::Channel: [" << p50_delta(Io_variant::S_STRUC_SYNC_IO, Io_variant::S_STRUC_ASYNC_IO)
+                  << " usec].");
+  }
+
+  if (cfg.m_ping_pong_rounds != 0)
+  {
+    FLOW_LOG_INFO("Small-message ping-pong over [" << transport_desc() << "] (structured: " << zcp_desc << "); "
+                  "one-way latency (half the RTT) in usec; msgs/sec = pings echoed per second, pipelined: ");
+    FLOW_LOG_INFO(setw(10) << "channel" << " | " << setw(8) << "size (B)" << " | " << setw(8) << "p50" << " | "
+                  << setw(8) << "p90" << " | " << setw(8) << "p99" << " | " << setw(8) << "p99.9" << " | "
+                  << setw(8) << "max" << " | " << setw(6) << "window" << " | " << setw(12) << "msgs/sec");
+    for (size_t chan_idx = 0; chan_idx != g_ping_pong.size(); ++chan_idx)
+    {
+      for (size_t sz_idx = 0; sz_idx != PING_PONG_SZS.size(); ++sz_idx)
+      {
+        const auto& result = g_ping_pong[chan_idx][sz_idx];
+        const auto chan_desc = (chan_idx == 0) ? "raw" : "structured";
+        if (!result.m_ok)
+        {
+          FLOW_LOG_INFO(setw(10) << chan_desc << " | " << setw(8) << PING_PONG_SZS[sz_idx] << " | "
+                        "(skipped: too large for this channel)");
+          continue;
+        }
+        // else
+        const auto& lat = result.m_one_way;
+        const double secs = boost::chrono::duration<double>(result.m_tput.m_elapsed).count();
+        FLOW_LOG_INFO(setw(10) << chan_desc << " | " << setw(8) << PING_PONG_SZS[sz_idx] << " | "
+                      << fixed << setprecision(2)
+                      << setw(8) << to_usec_f(lat.percentile(50)) << " | "
+                      << setw(8) << to_usec_f(lat.percentile(90)) << " | "
+                      << setw(8) << to_usec_f(lat.percentile(99)) << " | "
+                      << setw(8) << to_usec_f(lat.percentile(99.9)) << " | "
+                      << setw(8) << to_usec_f(lat.max()) << " | "
+                      << setw(6) << result.m_tput.m_window << " | " << setw(12) << setprecision(0)
+                      << ((secs == 0) ? 0 : (double(result.m_tput.m_n_msgs) / secs)));
+      }
+    }
+  }
+
+  if (g_results.size() == 1)
+  {
+    const auto& result = g_results.front();
+    auto raw_rtt = to_usec(result.m_capnp_over_raw_rtts.percentile(50));
+    auto zcp_rtt = to_usec(result.m_capnp_zero_cpy_rtts.percentile(50));
+    if (cfg.m_n_iterations == 1)
+    {
+      raw_rtt = ceil_div(raw_rtt, microseconds::rep(100)) * 100;
+      zcp_rtt = ceil_div(zcp_rtt, microseconds::rep(100)) * 100;
+      FLOW_LOG_INFO("Benchmark summary (rounded-up to 100-usec multiples): ");
+    }
+    else
+    {
+      FLOW_LOG_INFO("Benchmark summary (median RTTs): ");
+    }
+    FLOW_LOG_INFO("Transmission of ~[" << (result.m_total_sz / 1024) << " ki] of Cap'n Proto structured data: ");
+    FLOW_LOG_INFO("Via raw-" << transport_desc() << ": RTT = [" << raw_rtt << " usec].");
+    FLOW_LOG_INFO("Via-Flow-IPC-structured-channel (" << zcp_desc << "): RTT = [" << zcp_rtt << " usec].");
+    FLOW_LOG_INFO("Ratio = [" << float(raw_rtt) / float(zcp_rtt) << "].");
+    return;
+  }
+  // else
+
+  FLOW_LOG_INFO("Benchmark summary: sweep over [" << g_results.size() << "] sizes of Cap'n Proto structured data; "
+                "raw is over [" << transport_desc() << "]; zero-copy is [" << zcp_desc << "]; "
+                << ((cfg.m_n_iterations == 1) ? "" : "median ") << "RTTs in usec: ");
+  FLOW_LOG_INFO(setw(12) << "size (ki)" << " | " << setw(14) << "raw RTT" << " | "
+                << setw(14) << "zero-copy RTT" << " | " << setw(8) << "ratio");
+  /* Crossover = the smallest size, such that at it and all larger sizes zero-copy wins.  (Small sizes tend to be
+   * noisy, so a lone "win" below a loss doesn't count.) */
+  const Result* crossover = nullptr;
+  for (const auto& result : g_results)
+  {
+    const auto raw_rtt = result.m_capnp_over_raw_rtts.percentile(50);
+    const auto zcp_rtt = result.m_capnp_zero_cpy_rtts.percentile(50);
+    FLOW_LOG_INFO(setw(12) << (result.m_total_sz / 1024) << " | " << setw(14) << to_usec(raw_rtt) << " | "
+                  << setw(14) << to_usec(zcp_rtt) << " | "
+                  << setw(8) << float(to_usec(raw_rtt)) / float(to_usec(zcp_rtt)));
+
+    if (zcp_rtt < raw_rtt)
+    {
+      if (!crossover)
+      {
+        crossover = &result;
+      }
+    }
+    else
+    {
+      crossover = nullptr;
+    }
+  }
+
+  if (crossover)
+  {
+    FLOW_LOG_INFO("Crossover: zero-copy wins at ~[" << (crossover->m_total_sz / 1024) << " ki] and up.");
+  }
+  else
+  {
+    FLOW_LOG_INFO("Crossover: none found; zero-copy does not win at the largest size.");
+  }
+} // log_summary()
+
+void save_report(flow::log::Logger* logger_ptr, const Bench_cfg& cfg, size_t n_clients,
+                 const std::string& json_path, const std::string& csv_path)
+{
+  using flow::Flow_log_component;
+  using boost::lexical_cast;
+  using std::string;
+  using std::vector;
+  using std::pair;
+  using std::ofstream;
+
+  using Fields = vector<pair<string, string>>;
+
+  FLOW_LOG_SET_CONTEXT(logger_ptr, Flow_log_component::S_UNCAT);
+
+  if (json_path.empty() && csv_path.empty())
+  {
+    return;
+  }
+  // else
+
+  /* The report: some descriptive sections (all values are strings), then the metrics (all numbers).  The metric keys
+   * are meant to be stable across runs and versions, as perf_gate.sh (and whatever else) compares them by key.
+   * RTTs are medians etc. over --iterations rounds; in usec, with fractions (the small ones can be ~1 usec). */
+
+  const auto read_line = [](const char* path, const char* prefix) -> string
+  {
+    // 1st line of file `path` starting with `prefix`; sans that prefix.  Empty if none (or no such file).
+    std::ifstream is(path);
+    string line;
+    while (std::getline(is, line))
+    {
+      if (line.compare(0, std::strlen(prefix), prefix) == 0)
+      {
+        return line.substr(std::strlen(prefix));
+      }
+    }
+    return string();
+  };
+
+  ::utsname uts;
+  const bool uts_ok = ::uname(&uts) == 0;
+  char timestamp[32];
+  const auto now = std::time(nullptr);
+  std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  const vector<pair<string, Fields>> sections
+    {
+      { "build",
+        {
+          { "variant", build_variant() },
+          { "transport", transport_desc() },
+          { "serialize", serialize_desc(cfg.m_serialize_via) },
+          { "compiler", __VERSION__ },
+#ifdef NDEBUG
+          { "assertions", "off" }
+#else
+          { "assertions", "on" }
+#endif
+        } },
+      { "config",
+        {
+          { "iterations", lexical_cast<string>(cfg.m_n_iterations) },
+          { "throughput_secs", lexical_cast<string>(boost::chrono::duration<double>(cfg.m_tput_duration).count()) },
+          { "window", lexical_cast<string>(cfg.m_tput_window) },
+          { "clients", lexical_cast<string>(n_clients) },
+          { "io_overhead_rounds", lexical_cast<string>(cfg.m_io_overhead_rounds) },
+          { "ping_pong_rounds", lexical_cast<string>(cfg.m_ping_pong_rounds) },
+          { "busy_poll_usec",
+            lexical_cast<string>(boost::chrono::round<boost::chrono::microseconds>(cfg.m_busy_poll).count()) }
+        } },
+      { "env",
+        {
+          { "timestamp_utc", timestamp },
+          { "hostname", uts_ok ? uts.nodename : "" },
+          { "kernel", uts_ok ? (string(uts.sysname) + ' ' + uts.release + ' ' + uts.version) : "" },
+          { "machine", uts_ok ? uts.machine : "" },
+          { "cpu_model", read_line("/proc/cpuinfo", "model name\t: ") },
+          { "n_cpus", lexical_cast<string>(std::thread::hardware_concurrency()) },
+          // E.g., "always [madvise] never": the bracketed one is in effect.
+          { "thp_enabled", read_line("/sys/kernel/mm/transparent_hugepage/enabled", "") },
+          { "thp_defrag", read_line("/sys/kernel/mm/transparent_hugepage/defrag", "") }
+        } }
+    };
+
+  vector<pair<string, double>> metrics;
+  const auto to_usec = [](flow::Fine_duration dur) -> double
+  {
+    return boost::chrono::duration<double, boost::micro>(dur).count();
+  };
+  // E.g., pfx = "sz_1024.raw.", what = "rtt" => sz_1024.raw.rtt_p50_usec, etc.
+  const auto add_latencies = [&](const string& pfx, const string& what, const Histogram& lats)
+  {
+    metrics.emplace_back(pfx + what + "_p50_usec", to_usec(lats.percentile(50)));
+    metrics.emplace_back(pfx + what + "_p90_usec", to_usec(lats.percentile(90)));
+    metrics.emplace_back(pfx + what + "_p99_usec", to_usec(lats.percentile(99)));
+    metrics.emplace_back(pfx + what + "_p99_9_usec", to_usec(lats.percentile(99.9)));
+    metrics.emplace_back(pfx + what + "_max_usec", to_usec(lats.max()));
+    metrics.emplace_back(pfx + what + "_mean_usec", to_usec(lats.mean()));
+    metrics.emplace_back(pfx + what + "_cv", lats.coeff_of_variation());
+  };
+  const auto msgs_per_sec = [](const Throughput& tput) -> double
+  {
+    const double secs = boost::chrono::duration<double>(tput.m_elapsed).count();
+    return (secs == 0) ? 0 : (double(tput.m_n_msgs) / secs);
+  };
+  // Per round (as in log_summary()), except the levels.  Informational: perf_gate.sh gates none of these by default.
+  const auto add_usage = [&](const string& pfx, const Res_usage& usage, uint64_t n_rounds)
+  {
+    const auto per = [&](uint64_t val) -> double { return double(val) / double(std::max(n_rounds, uint64_t(1))); };
+    metrics.emplace_back(pfx + "vol_csw_per_round", per(usage.m_ctx_switches.m_voluntary));
+    metrics.emplace_back(pfx + "invol_csw_per_round", per(usage.m_ctx_switches.m_involuntary));
+    metrics.emplace_back(pfx + "minor_faults_per_round", per(usage.m_minor_faults));
+    metrics.emplace_back(pfx + "major_faults_per_round", per(usage.m_major_faults));
+    metrics.emplace_back(pfx + "read_syscalls_per_round", per(usage.m_read_syscalls));
+    metrics.emplace_back(pfx + "write_syscalls_per_round", per(usage.m_write_syscalls));
+    metrics.emplace_back(pfx + "read_bytes_per_round", per(usage.m_read_bytes));
+    metrics.emplace_back(pfx + "write_bytes_per_round", per(usage.m_write_bytes));
+    metrics.emplace_back(pfx + "peak_rss_kib", double(usage.m_peak_rss_kib));
+    metrics.emplace_back(pfx + "shmem_rss_kib", double(usage.m_shmem_rss_kib));
+  };
+
+  for (const auto& result : g_results)
+  {
+    const auto sz_pfx = "sz_" + lexical_cast<string>(result.m_req_sz) + '.';
+    metrics.emplace_back(sz_pfx + "total_bytes", double(result.m_total_sz));
+    metrics.emplace_back(sz_pfx + "raw.msgs_per_wakeup",
+                         double(result.m_capnp_over_raw_n_msgs)
+                           / double(std::max(result.m_capnp_over_raw_n_wakeups, uint64_t(1))));
+    for (const auto raw_else_zcp : { true, false })
+    {
+      const auto pfx = sz_pfx + (raw_else_zcp ? "raw." : "flow_ipc.");
+      const auto& rtts = raw_else_zcp ? result.m_capnp_over_raw_rtts : result.m_capnp_zero_cpy_rtts;
+      add_latencies(pfx, "rtt", rtts);
+      add_usage(pfx, raw_else_zcp ? result.m_capnp_over_raw_usage : result.m_capnp_zero_cpy_usage, rtts.count());
+      if (cfg.m_tput_duration != flow::Fine_duration::zero())
+      {
+        const auto& tput = raw_else_zcp ? result.m_capnp_over_raw_tput : result.m_capnp_zero_cpy_tput;
+        metrics.emplace_back(pfx + "tput_window", double(tput.m_window));
+        metrics.emplace_back(pfx + "tput_msgs_per_sec", msgs_per_sec(tput));
+        metrics.emplace_back(pfx + "tput_gib_per_sec",
+                             msgs_per_sec(tput) * double(result.m_total_sz) / double(1024 * 1024 * 1024));
+      }
+    }
+  }
+
+  if (cfg.m_io_overhead_rounds != 0)
+  {
+    constexpr std::array<const char*, N_IO_VARIANTS> KEYS
+      = { "raw_sync_io", "raw_async_io", "struc_sync_io", "struc_async_io" };
+    for (size_t idx = 0; idx != N_IO_VARIANTS; ++idx)
+    {
+      const auto& result = g_io_overhead[idx];
+      const auto pfx = string("io.") + KEYS[idx] + '.';
+      const auto n_rtts = double(std::max(result.m_rtts.count(), uint64_t(1)));
+      add_latencies(pfx, "rtt", result.m_rtts);
+      metrics.emplace_back(pfx + "vol_csw_per_rtt", double(result.m_ctx_switches.m_voluntary) / n_rtts);
+      metrics.emplace_back(pfx + "invol_csw_per_rtt", double(result.m_ctx_switches.m_involuntary) / n_rtts);
+    }
+  }
+
+  if (cfg.m_ping_pong_rounds != 0)
+  {
+    for (size_t chan_idx = 0; chan_idx != g_ping_pong.size(); ++chan_idx)
+    {
+      for (size_t sz_idx = 0; sz_idx != PING_PONG_SZS.size(); ++sz_idx)
+      {
+        const auto& result = g_ping_pong[chan_idx][sz_idx];
+        if (!result.m_ok)
+        {
+          continue; // The key's absence says it all.
+        }
+        // else
+        const auto pfx = string("ping_pong.") + ((chan_idx == 0) ? "raw" : "struc")
+                           + ".sz_" + lexical_cast<string>(PING_PONG_SZS[sz_idx]) + '.';
+        add_latencies(pfx, "one_way", result.m_one_way);
+        metrics.emplace_back(pfx + "tput_window", double(result.m_tput.m_window));
+        metrics.emplace_back(pfx + "tput_msgs_per_sec", msgs_per_sec(result.m_tput));
+      }
+    }
+  }
+
+  const auto open = [&](const string& path) -> ofstream
+  {
+    ofstream os(path);
+    if (!os)
+    {
+      throw Runtime_error("Could not open [" + path + "] for writing.");
+    }
+    os << std::setprecision(10);
+    return os;
+  };
+
+  if (!json_path.empty())
+  {
+    const auto quoted = [](const string& str) -> string
+    {
+      string out = "\"";
+      for (const char ch : str)
+      {
+        if ((ch == '"') || (ch == '\\'))
+        {
+          out += '\\';
+          out += ch;
+        }
+        else if (uint8_t(ch) < 0x20)
+        {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", unsigned(uint8_t(ch)));
+          out += buf;
+        }
+        else
+        {
+          out += ch;
+        }
+      }
+      return out + '"';
+    };
+
+    auto os = open(json_path);
+    os << "{\n";
+    for (const auto& section : sections)
+    {
+      os << "  " << quoted(section.first) << ": {\n";
+      for (size_t idx = 0; idx != section.second.size(); ++idx)
+      {
+        os << "    " << quoted(section.second[idx].first) << ": " << quoted(section.second[idx].second)
+           << ((idx + 1 == section.second.size()) ? "\n" : ",\n");
+      }
+      os << "  },\n";
+    }
+    os << "  \"metrics\": {\n";
+    for (size_t idx = 0; idx != metrics.size(); ++idx)
+    {
+      os << "    " << quoted(metrics[idx].first) << ": " << metrics[idx].second
+         << ((idx + 1 == metrics.size()) ? "\n" : ",\n");
+    }
+    os << "  }\n}\n";
+    FLOW_LOG_INFO("Saved results (JSON) to [" << json_path << "].");
+  }
+
+  if (!csv_path.empty())
+  {
+    // 1 row per item: <section>.<name>,<value>.  Then the metrics: <key>,<value>.
+    const auto quoted = [](const string& str) -> string
+    {
+      if (str.find_first_of(",\"\n") == string::npos)
+      {
+        return str;
+      }
+      // else
+      string out = "\"";
+      for (const char ch : str)
+      {
+        out += ch;
+        if (ch == '"')
+        {
+          out += '"';
+        }
+      }
+      return out + '"';
+    };
+
+    auto os = open(csv_path);
+    os << "key,value\n";
+    for (const auto& section : sections)
+    {
+      for (const auto& field : section.second)
+      {
+        os << section.first << '.' << field.first << ',' << quoted(field.second) << '\n';
+      }
+    }
+    for (const auto& metric : metrics)
+    {
+      os << metric.first << ',' << metric.second << '\n';
+    }
+    FLOW_LOG_INFO("Saved results (CSV) to [" << csv_path << "].");
+  }
+} // save_report()
@@ -16,6 +16,18 @@
  * permissions and limitations under the License. */
 
 #include "common.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
 
 /* perf_demo_srv (this guy) and perf_demo_cli (main_cli.cpp) are two programs to be executed from
  * the same CWD, where they should both be placed.  First run the server program; once it says one can now
@@ -24,12 +36,57 @@
  * will begin the benchmark run; once it is done, both programs will exit.  The client's console shall print
  * a benchmark summary.
  *
- * If macro JEM_ELSE_CLASSIC is set to 1, the SHM-provider providing zero-copy mechanics (internally) will be
- * SHM-jemalloc.  Otherwise (e.g., undefined or set to 0) it will be SHM-classic.  (In our experience the benchmark
- * results so far are pretty similar, but it's still nice to exercise both.)  As of this writing the nearby
- * build script shall generate both pairs of programs:
- * perf_demo_{srv|cli}_shm_classic.exec and perf_demo_{srv|cli}_shm_jemalloc.exec.  So pick which type you want
- * and then execute that pair, in server-then-client order.
+ * Instead of a size the server can be given the word `sweep`: then it serves a log-spaced series of data sizes
+ * (1 Ki, 4 Ki, ..., up to --sweep-max-mi: 64 Mi by default) instead of just 1, and the client will run each
+ * benchmark at each of those sizes, printing a table of RTTs versus size.  That's the way to find the size above
+ * which zero-copy starts to pay off (the crossover).
+ *
+ * With --clients=K the server accepts K sessions (K client processes; see perf_demo_cli --clients, which launches
+ * them all at once) and serves them all concurrently, each running the same benchmarks as usual.  By default
+ * that's all from this 1 thread; with --threads=T it's from T threads (each with its own event loop; the clients
+ * being divided among them round-robin).  That's the 1-daemon-many-workers deployment shape: how does the thing
+ * scale as clients (and serving cores) are added?
+ *
+ * If the client is given --io-overhead=N, then after those benchmarks there's a 3rd one: a tiny message echoed back
+ * and forth N times via the sync_io-pattern API (as everywhere else here); and then the same via the async-I/O-pattern
+ * API; for raw and structured channels both.  The client reports the latency difference and the context switches
+ * per round trip.  That's what the sync_io pattern saves; if you're wondering whether it's worth the trouble.
+ *
+ * If the client is given --ping-pong=N, then after that there's a 4th one: blobs of 8 B, 64 B, 1 KiB, 16 KiB, and
+ * 64 KiB (those the channel can carry in 1 message) are echoed back and forth N times each, over a raw channel and a
+ * structured one; then N more with several in flight.  The client reports one-way latency and messages/sec.  Run it
+ * on each build in the matrix (see below) to compare the transports (Unix domain socket, POSIX MQ, bipc MQ) for the
+ * small request/ack traffic that makes up most control-plane IPC.
+ *
+ * If the server is given --build-cost=N, then before all that it times the construction of the response message
+ * itself, N times per size: directly in a capnp::MallocMessageBuilder (also one recycling its buffer, as a segment
+ * pool would), a Heap_fixed_builder, and the structured channel's own (SHM-backed, unless heap) builder; and the deep
+ * copy into the latter that the zero-copy benchmark does, untimed, up-front.  See run_build_cost().  (Zero-copy
+ * transmission is only half the story if the message is built for each request: which it usually is.)
+ *
+ * Both sides also account for the OS resources used (see Res_usage in common.hpp): context switches, page faults,
+ * read()/write()-like syscalls and the bytes through them, peak RSS, and resident SHM.  The client reports them
+ * per round, over the timed part only, next to the RTTs (and in --json/--csv); the server, which times nothing,
+ * logs its own totals after each benchmark.  A raw RTT that grows with size should come with bytes and syscalls that
+ * grow too; a zero-copy one should not.
+ *
+ * Given --busy-poll-usec=U (on either side; or both, to see the full effect), that side's event loop(s), whenever
+ * idle, keep checking for events for up to U usec before going to sleep in the kernel: a core's worth of CPU
+ * traded for the wakeup latency on each message received.  See run_event_loop() in common.hpp.
+ *
+ * Macro SHM_PROVIDER selects the SHM-provider providing zero-copy mechanics (internally): SHM-classic or SHM-jemalloc;
+ * or none, in which case the 2nd benchmark uses Flow-IPC structured messaging without zero-copy (heap-serialized).
+ * (In our experience the SHM-classic and SHM-jemalloc results so far are pretty similar, but it's still nice to
+ * exercise both.)  Macro MQ_TYPE selects what the channels are made of: Unix domain socket (default), POSIX MQ,
+ * or bipc MQ.  See common.hpp.  As of this writing the nearby build script shall generate a pair of programs for each
+ * combination: perf_demo_{srv|cli}_{shm_classic|shm_jemalloc|heap}[_mq_posix|_mq_bipc].exec.  So pick which type you
+ * want and then execute that pair, in server-then-client order.  (Or use run_matrix.sh to run them all.)
+ * With a SHM-provider, --serialize=app-shm (on both sides) makes the structured messages come from the per-app SHM
+ * arena instead of the per-session one (--serialize=session-shm, the default).
+ *
+ * The client can also save its results, with the build config and some info about the machine, via --json=<file>
+ * and/or --csv=<file>.  perf_gate.sh (CMake targets perf_demo_gate_record, then perf_demo_gate) uses that to compare
+ * a few runs against a stored baseline, failing if the latency or throughput regressed beyond a tolerance.
  *
  * Bit of a disclaimer
  * -------------------
@@ -56,6 +113,30 @@
 using Session = Session_server::Server_session_obj;
 // For when we test "classic" use of Cap'n Proto (capnp), sans Flow-IPC structured-transport layer.
 using Capnp_heap_engine = ::capnp::MallocMessageBuilder;
+using Capnp_segs = kj::ArrayPtr<const kj::ArrayPtr<const ::capnp::word>>;
+
+// Everything about 1 accepted session (i.e., 1 client process).
+struct Client
+{
+  Session m_session;
+  // [0] is used raw; [1] is upgraded to m_chan_struc.
+  Session_server::Channels m_chans;
+  std::optional<Channel_struc> m_chan_struc;
+  // How m_chan_struc serializes (--serialize).
+  Serialize_via m_serialize_via = Serialize_via::S_HEAP;
+  /* Init-channels the client asked for itself: none; or N_IO_VARIANTS, if it wants to run the --io-overhead benchmark
+   * (run_io_overhead()).  Then [i] is for Io_variant i: [S_RAW_SYNC_IO] is used raw; the others are upgraded to
+   * the following.  Plus, after those, N_PING_PONG_CHANS if it wants the --ping-pong one (run_ping_pong()): those are
+   * moved into m_ping_raw and upgraded to m_ping_struc respectively. */
+  Session_server::Channels m_cli_chans;
+  std::optional<Channel_raw_aio> m_io_raw_aio;
+  std::optional<Channel_struc> m_io_struc_sio;
+  std::optional<Channel_struc_aio> m_io_struc_aio;
+  std::optional<Channel_raw> m_ping_raw;
+  std::optional<Channel_struc> m_ping_struc;
+  // Which of g_asios[] serves this guy.
+  Task_engine* m_asio = nullptr;
+};
 
 /* In this app we stubbornly stick to the original thread without creating new ones.  This is partially to show
  * an example that it can be done if desired, via use of sync_io-pattern API; and more importantly to not even
@@ -65,18 +146,86 @@ using Capnp_heap_engine = ::capnp::MallocMessageBuilder;
  * This boost::asio::io_context's .run() is executed from (as) the original thread, and the various Flow-IPC async ops
  * hook into this event loop.
  *
+ * That is unless --threads=T > 1: then there are T of these, the 1st run from the original thread as before,
+ * the others each from a thread of its own.  Each client is served by exactly 1 of them (see Client::m_asio);
+ * so the objects of a given client are still only ever touched from 1 thread, and no locking is needed.
+ * (It's still the sync_io-pattern API: we just have more than 1 event loop.)
+ *
  * It doesn't need to be global; it's just for coding expediency (for now at least), as it's referenced in a few
- * benchmarks.  Same with g_capnp_msg. */
-static Task_engine g_asio;
-/* This is where we keep large capnp-structured data.  We fill it up at the start of main(), and at least one benchmark
+ * benchmarks.  Same with g_total_szs and g_capnp_msgs. */
+static std::vector<std::unique_ptr<Task_engine>> g_asios;
+/* --busy-poll-usec: if not zero, run_event_loops() runs each of g_asios busy-polling for this long, when idle, before
+ * sleeping (see run_event_loop()); and adds up how that went in g_busy_poll_stats (all of them together). */
+static flow::Fine_duration g_busy_poll = flow::Fine_duration::zero();
+static Busy_poll_stats g_busy_poll_stats;
+/* The rough data sizes (in bytes) we advertise to the client: normally just 1; in sweep mode a series of them.
+ * The client then requests each one by that size, in this order. */
+static std::vector<size_t> g_total_szs;
+/* This is where we keep large capnp-structured data: 1 message per size in g_total_szs.  At least one benchmark
  * transmits its backing serialization capnp-segments over an IPC channel (local stream socket).  Then at least one
  * other benchmark *deep-copies* it into a Flow-IPC SHM-backed MessageBuilder (*not* a capnp::MallocMessageBuilder like
  * this guy) and sends that.  If we add more benchmarks that need large capnp-structured data, we'll likely similarly
- * deep-copy this into whatever MessageBuilder is applicable. */
-static Capnp_heap_engine g_capnp_msg;
+ * deep-copy this into whatever MessageBuilder is applicable.
+ *
+ * With 1 client each is built when first needed (capnp_msg()); and freed once the client's benchmark is done with it,
+ * as the benchmarks hold it only while serving that size.  So there are only ever ~1-2 of them around, even in sweep
+ * mode.  With several clients, though, building on demand would be done from an event loop, delaying the other
+ * clients on it (and, while holding g_capnp_msgs_mutex, those on the other loops wanting that size) mid-benchmark;
+ * and a size would be rebuilt for a slower client after the others had moved on (freeing it).  So then main()
+ * builds them all up-front, before accepting any session, and keeps them (g_capnp_msgs_pinned) until exit.
+ * Once built it is only read (via the members below, computed up-front), so the event loops can share it. */
+struct Capnp_msg
+{
+  Capnp_heap_engine m_builder;
+  perf_demo::schema::Body::Reader m_root;
+  /* m_builder.getSegmentsForOutput(); and the header run_capnp_over_raw() sends before them: the segment count N,
+   * then those N segments' sizes in bytes. */
+  Capnp_segs m_segs;
+  std::vector<size_t> m_hdr;
+};
+static std::mutex g_capnp_msgs_mutex;
+static std::map<size_t, std::weak_ptr<const Capnp_msg>> g_capnp_msgs;
+static std::vector<std::shared_ptr<const Capnp_msg>> g_capnp_msgs_pinned;
+
+/* Counts down the clients (across all event loops) not yet done with a benchmark; the last one to be done stops
+ * all of g_asios, so run_event_loops() returns.  For the benchmarks whose loops would not run out of work on their
+ * own: a struc::Channel is always reading all internally incoming messages ASAP; so it always has an .async_wait()
+ * outstanding.  Hence the .run() never runs out of work, unless we flip the g_asios[] internal "is-stopped" switch
+ * which causes it to in fact return the moment the .stop()ping task (function, such as the one calling
+ * client_done()) returns.  .stop() flips that switch.  (For the other loops, if any, it's the moment they're done
+ * with whatever task they're executing; they're idle though: all of their clients are done too.) */
+class Run_countdown
+{
+public:
+  explicit Run_countdown(size_t n_clients) :
+    m_n_running(n_clients)
+  {
+  }
+
+  // Call once per client, when it's done; from any event loop.
+  void client_done()
+  {
+    if (--m_n_running == 0)
+    {
+      for (auto& asio : g_asios)
+      {
+        asio->stop();
+      }
+    }
+  }
+
+private:
+  std::atomic<size_t> m_n_running;
+};
 
-void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan);
-void run_capnp_zero_copy(flow::log::Logger* logger_ptr, Channel_struc* chan, Session* session_ptr);
+void fill_rsp(perf_demo::schema::GetCacheRsp::Builder rsp_root, size_t total_sz);
+std::shared_ptr<const Capnp_msg> capnp_msg(flow::log::Logger* logger_ptr, size_t total_sz);
+void run_capnp_over_raw(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients);
+void run_capnp_zero_copy(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients);
+void run_io_overhead(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients);
+void run_ping_pong(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients);
+void run_build_cost(flow::log::Logger* logger_ptr, Client* client_ptr, size_t n_msgs);
+void run_event_loops();
 
 int main(int argc, char const * const * argv)
 {
@@ -89,18 +238,46 @@ int main(int argc, char const * const * argv)
   using boost::lexical_cast;
   using std::exception;
   using std::optional;
+  using std::vector;
+  using std::unique_ptr;
+  using std::make_unique;
 
   constexpr float TOTAL_SZ_MI = 1 * 1000;
+  constexpr String_view SWEEP_MODE = "sweep";
+  /* In sweep mode: 1Ki, 4Ki, 16Ki, ..., up to --sweep-max-mi.  By default not quite as far as TOTAL_SZ_MI: each
+   * client gets its own SHM copy of the response it's on (see run_capnp_zero_copy()); so with several --clients
+   * the large sizes add up.  Heap-serialized structured messages cannot be that large anyway (see fill_rsp()). */
+  constexpr size_t SWEEP_MIN_SZ = 1024;
+#if SHM_PROVIDER == SHM_PROVIDER_NONE
+  constexpr size_t SWEEP_MAX_MI = 1;
+#else
+  constexpr size_t SWEEP_MAX_MI = 64;
+#endif
+  constexpr size_t SWEEP_FACTOR = 4;
 
   /* Set up logging within this function.  We could easily just use `cout` and `cerr` instead, but this
    * Flow stuff will give us time stamps and such for free, so why not?  Normally, one derives from
    * Log_context to do this very trivially, but we just have the one function, main(), so far so: */
   optional<Simple_ostream_logger> std_logger;
   optional<Async_file_logger> log_logger;
-  setup_logging(&std_logger, &log_logger, argc, argv, true);
+  const Cmd_line cmd_line(argc, argv);
+  setup_logging(&std_logger, &log_logger, cmd_line, true);
   FLOW_LOG_SET_CONTEXT(&(*std_logger), Flow_log_component::S_UNCAT);
 
-#if JEM_ELSE_CLASSIC
+  const auto n_clients = cmd_line.opt<size_t>("clients", 1);
+  const auto n_threads = std::min(cmd_line.opt<size_t>("threads", 1), n_clients);
+  const auto n_build_cost_msgs = cmd_line.opt<size_t>("build-cost", 0);
+  const auto sweep_max_mi = cmd_line.opt<size_t>("sweep-max-mi", SWEEP_MAX_MI);
+  g_busy_poll = boost::chrono::microseconds(cmd_line.opt<size_t>("busy-poll-usec", 0));
+  FLOW_LOG_INFO("Usage: " << argv[0] << " [<rough data size in Mi (default [" << TOTAL_SZ_MI << "])> | "
+                << SWEEP_MODE << "] [<log file>] [--clients=<sessions to accept and serve at once (default 1)>] "
+                "[--sweep-max-mi=<largest size in sweep mode, in Mi (default [" << SWEEP_MAX_MI << "])>] "
+                "[--threads=<threads serving them (default 1)>] "
+                "[--serialize=<session-shm (default) | app-shm | heap (default, and only choice, in *_heap* build)>] "
+                "[--build-cost=<messages per builder, in message-construction benchmark (default 0 = skip)>] "
+                "[--busy-poll-usec=<spin this long when idle, before sleeping (default 0 = never spin)>]");
+
+#if SHM_PROVIDER == SHM_PROVIDER_JEMALLOC
   /* Instructed to do so by ipc::session::shm::arena_lend public docs (short version: this is basically a global,
    * and it would not be cool for ipc::session non-global objects to impose their individual loggers on it). */
   ipc::session::shm::arena_lend::Borrower_shm_pool_collection_repository_singleton::get_instance()
@@ -110,11 +287,38 @@ int main(int argc, char const * const * argv)
   try
   {
     ensure_run_env(argv[0], true);
+    if ((n_clients == 0) || (n_threads == 0))
+    {
+      throw Runtime_error("--clients and --threads must be at least 1.");
+    }
+    const auto serialize = serialize_via(cmd_line);
 
     {
-      const auto total_sz_mi = (argc >= 2) ? lexical_cast<float>(argv[1]) : TOTAL_SZ_MI;
+      auto& total_szs = g_total_szs;
+      if ((cmd_line.n_pos_args() >= 2) && (cmd_line.pos_arg(1) == SWEEP_MODE))
+      {
+        for (size_t total_sz = SWEEP_MIN_SZ; total_sz <= sweep_max_mi * 1024 * 1024; total_sz *= SWEEP_FACTOR)
+        {
+          total_szs.push_back(total_sz);
+        }
+        if (total_szs.empty())
+        {
+          throw Runtime_error("--sweep-max-mi must be at least 1.");
+        }
+      }
+      else
+      {
+        const auto total_sz_mi = (cmd_line.n_pos_args() >= 2) ? lexical_cast<float>(cmd_line.pos_arg(1))
+                                                              : TOTAL_SZ_MI;
+        total_szs.push_back(size_t(total_sz_mi * 1024.f * 1024.f));
+        if (total_szs.front() == 0)
+        {
+          throw Runtime_error("Data size must be at least 1 byte.");
+        }
+      }
+      assert(total_szs.size() <= MAX_N_SIZES);
 
-      /* Fill out vanilla capnp::MallocMessageBuilder g_capnp_msg with a whole bunch of data.
+      /* Each of g_capnp_msgs[] is a vanilla capnp::MallocMessageBuilder, filled with a whole bunch of data.
        * A given benchmark can then transmit this directly; or prepare a perhaps-non-vanilla MessageBuilder
        * (perhaps a fancy Flow-IPC SHM-backed one!) and deep-copy this guy into that, for identical data
        * that the opposing side can (upon receipt) access and verify using the exact same code.
@@ -134,87 +338,154 @@ int main(int argc, char const * const * argv)
        *     that result.
        *   - Client then runs through the whole structure and checks file-part hashes and sizes and what-not.
        *
-       * So g_capnp_msg will be the "gold copy" of the data structure being used in such benchmarks.
+       * So g_capnp_msgs[] will be the "gold copy" of the data structure being used in such benchmarks.
        * Note that this is *completely* vanilla capnp-using code; there's nothing Flow-IPC-ish going on here
-       * at all.  Even the backing MessageBuilder is just good ol' capnp::MallocMessageBuilder. */
-      FLOW_LOG_INFO("Prep: Patience!  No need to try running client until we say server is up.");
-      FLOW_LOG_INFO("Prep: Filling capnp MallocMessageBuilder (rough size [" << total_sz_mi << " Mi]): START.");
-      constexpr size_t FILE_PART_SZ = 16 * 1024;
-
-      auto file_parts_list = g_capnp_msg.initRoot<perf_demo::schema::Body>().initGetCacheRsp()
-                               .initFileParts
-                                  (ceil_div(size_t(total_sz_mi * 1024.f * 1024.f), FILE_PART_SZ));
-      for (size_t idx = 0; idx != file_parts_list.size(); ++idx)
-      {
-        auto file_part = file_parts_list[idx];
-        auto data = file_part.initData(FILE_PART_SZ);
-        for (size_t byte_idx = 0; byte_idx != FILE_PART_SZ; ++byte_idx)
+       * at all.  Even the backing MessageBuilder is just good ol' capnp::MallocMessageBuilder.
+       *
+       * In sweep mode we simply do all that once per size; the client requests each one in turn.  With 1 client the
+       * preparing happens when it first asks for a size (see capnp_msg()); which the client, knowing that, does not
+       * time (it begins each size with an untimed warm-up round).  With several it happens right here (see
+       * g_capnp_msgs_pinned for why). */
+      if (n_clients > 1)
+      {
+        FLOW_LOG_INFO("Prep: Patience!  No need to try running client until we say server is up.");
+        for (const auto total_sz : total_szs)
         {
-          data[byte_idx] = uint8_t(byte_idx % 256); // Dummy data... let's not just leave it as zeroes.
+          g_capnp_msgs_pinned.push_back(capnp_msg(&(*std_logger), total_sz));
         }
-        file_part.setDataSizeToVerify(FILE_PART_SZ);
-        /* Obviously a Boost string hash is not a cryptographically sound hash.  Fine for our purposes
-         * of sanity-checking that whatever the client received and accessed was at least mutually consistent nad
-         * not junk that accidentally didn't cause capnp to throw an exception during an accessor. */
-        file_part.setDataHashToVerify(boost::hash<String_view>()
-                                        (String_view(reinterpret_cast<const char*>(data.begin()), FILE_PART_SZ)));
       }
-
-      /* Note total_sz_mi is just a rough guide; we only count the GetCacheRsp.data field as "taking space";
-       * there's also nearby hash and size fields, plus capnp format overhead.  That said even with small
-       * sizes like 10kib it's a pretty decent estimate, it turns out.  (And it's certainly proportional at least.) */
-
-      FLOW_LOG_INFO("Prep: Filling capnp MallocMessageBuilder: DONE.");
+      FLOW_LOG_INFO("Will serve [" << total_szs.size() << "] size(s), from "
+                    "[" << ceil_div(total_szs.front(), size_t(1024)) << " Ki] "
+                    "to [" << ceil_div(total_szs.back(), size_t(1024)) << " Ki].");
     }
 
-    /* Accept one session.  Use the async-I/O API, as perf for this part really doesn't matter to anyone ever,
+    /* Accept the session(s).  Use the async-I/O API, as perf for this part really doesn't matter to anyone ever,
      * and we're not timing it anyway, and it doesn't affect what happens after.  We don't start a thread; just
-     * use promise/future pattern to wait until Session_server is ready with success or failure. */
+     * use promise/future pattern to wait until Session_server is ready with success or failure.  If there are
+     * several clients, they're accepted one after another, until all have connected; only then do the benchmarks
+     * begin (for all of them at once). */
     Session_server srv(&(*log_logger), SRV_APPS.find(SRV_NAME)->second, CLI_APPS);
     FLOW_LOG_INFO("Session-server started.  You can now invoke session-client executable from same CWD; "
-                  "it will open session with some channel(s).");
+                  "it will open session with some channel(s).  Expecting [" << n_clients << "] client(s); "
+                  "they will be served from [" << n_threads << "] thread(s).");
 
-    Session session;
-    promise<Error_code> accepted_promise;
-    Session_server::Channels chans;
-    srv.async_accept(&session, &chans, nullptr, nullptr,
-                     [](auto&&...) -> size_t { return 2; }, // 2 init-channels to open.
-                     [](auto&&...) {},
-                     [&](const Error_code& err_code)
+    for (size_t idx = 0; idx != n_threads; ++idx)
     {
-      accepted_promise.set_value(err_code);
-    });
-    const auto err_code = accepted_promise.get_future().get();
-    if (err_code)
-    {
-      throw Runtime_error(err_code, "totally unexpected error while accepting");
-    }
-    // else
-    FLOW_LOG_INFO("Session accepted: [" << session << "].");
-
-    /* Ignore session errors (see disclaimer comment at top of for general justification).
-     * Basically we know it'll be, if anything, just the client disconnecting from us when it's done; and by that
-     * point we'll be shutting down anyway.  And any transmission error will be detected along the channel of
-     * transmission.  As a not-serious-production-app, no need for this stuff. */
-    session.init_handlers([](auto&&...) {});
-    // Session in PEER state (opened fully); so channels are ready too.
-
-    /* For now there are just these two channels.  (See above where we specified `return 2`.)
-     * You'll see in common.hpp that by setting a certain single type-alias, each channel is simply a
-     * local-stream-socket (a/k/a Unix domain socket) full-duplex connection.  (We could as of this writing instead
-     * set it to a POSIX MQ, or bipc MQ; it would be just a matter of changing that one alias.  We chose
-     * local-stream-socket, because it's a popular choice for people by default, and we'd like to run our
-     * no-Flow-IPC benchmark over that.)
-     *
-     * This one we'll just keep using in this raw form (no Flow-IPC transport::struc::Channel over it). */
-    auto& chan_raw = chans[0];
-
-    // And this one we immediately upgrade to a Flow-IPC transport::struc::Channel.
-    Channel_struc chan_struc(&(*log_logger), std::move(chans[1]), // Structured channel: SHM-backed underneath.
-                             ipc::transport::struc::Channel_base::S_SERIALIZE_VIA_SESSION_SHM, &session);
-
-    run_capnp_over_raw(&(*std_logger), &chan_raw); // Benchmark 1.  capnp data transmission without Flow-IPC zero-copy.
-    run_capnp_zero_copy(&(*std_logger), &chan_struc, &session); // Benchmark 2.  Same but with it.
+      g_asios.emplace_back(make_unique<Task_engine>());
+    }
+
+    vector<unique_ptr<Client>> clients;
+    for (size_t idx = 0; idx != n_clients; ++idx)
+    {
+      auto& client = *clients.emplace_back(make_unique<Client>());
+      client.m_asio = g_asios[idx % n_threads].get();
+
+      promise<Error_code> accepted_promise;
+      srv.async_accept(&client.m_session, &client.m_chans, nullptr, &client.m_cli_chans,
+                       [](auto&&...) -> size_t { return 2; }, // 2 init-channels to open.
+                       [](auto&&...) {},
+                       [&](const Error_code& err_code)
+      {
+        accepted_promise.set_value(err_code);
+      });
+      const auto err_code = accepted_promise.get_future().get();
+      if (err_code)
+      {
+        throw Runtime_error(err_code, "totally unexpected error while accepting");
+      }
+      // else
+      FLOW_LOG_INFO("Session [" << (idx + 1) << '/' << n_clients << "] accepted: [" << client.m_session << "].");
+
+      /* Ignore session errors (see disclaimer comment at top of for general justification).
+       * Basically we know it'll be, if anything, just the client disconnecting from us when it's done; and by that
+       * point we'll be shutting down anyway.  And any transmission error will be detected along the channel of
+       * transmission.  As a not-serious-production-app, no need for this stuff. */
+      client.m_session.init_handlers([](auto&&...) {});
+      // Session in PEER state (opened fully); so channels are ready too.
+
+      /* Our 2 init-channels (see above where we specified `return 2`) are for the capnp benchmarks; plus those the
+       * client asked for, if any (see below).  What each channel is made of is decided at build time, by MQ_TYPE
+       * (see common.hpp; and the CMake build, which can build every combination): a local-stream-socket (a/k/a Unix
+       * domain socket) full-duplex connection (the default, and a popular choice; so it's what our no-Flow-IPC
+       * benchmark runs over by default); or a pair of POSIX or bipc MQs (no socket at all: we don't transmit native
+       * handles).  run_matrix.sh runs them all, to compare.
+       *
+       * The 1st one we'll just keep using in this raw form (no Flow-IPC transport::struc::Channel over it).
+       * And the 2nd one we immediately upgrade to a Flow-IPC transport::struc::Channel. */
+      client.m_serialize_via = serialize;
+      emplace_channel_struc(&client.m_chan_struc, &(*log_logger), std::move(client.m_chans[1]), // Structured channel.
+                            &client.m_session, serialize);
+
+      /* Plus, if the client wants the --io-overhead and/or --ping-pong benchmarks, the channels it asked for (see
+       * Client::m_cli_chans).  All the clients are launched together with the same options; so they should all
+       * agree. */
+      auto& cli_chans = client.m_cli_chans;
+      const auto n_cli_chans = cli_chans.size();
+      const bool io_overhead = n_cli_chans >= N_IO_VARIANTS;
+      const auto n_io_chans = io_overhead ? N_IO_VARIANTS : 0;
+      const bool ping_pong = (n_cli_chans - n_io_chans) == N_PING_PONG_CHANS;
+      if ((n_cli_chans != clients.front()->m_cli_chans.size())
+          || (n_cli_chans != (n_io_chans + (ping_pong ? N_PING_PONG_CHANS : 0))))
+      {
+        throw Runtime_error("Client asked for an unexpected number of init-channels.  "
+                            "Mismatched --io-overhead or --ping-pong?");
+      }
+      // else
+      if (io_overhead)
+      {
+        client.m_io_raw_aio.emplace(cli_chans[size_t(Io_variant::S_RAW_ASYNC_IO)].async_io_obj());
+        emplace_channel_struc(&client.m_io_struc_sio, &(*log_logger),
+                              std::move(cli_chans[size_t(Io_variant::S_STRUC_SYNC_IO)]), &client.m_session, serialize);
+        emplace_channel_struc(&client.m_io_struc_aio, &(*log_logger),
+                              std::move(cli_chans[size_t(Io_variant::S_STRUC_ASYNC_IO)]), &client.m_session,
+                              serialize);
+      }
+      if (ping_pong)
+      {
+        client.m_ping_raw.emplace(std::move(cli_chans[n_io_chans]));
+        emplace_channel_struc(&client.m_ping_struc, &(*log_logger), std::move(cli_chans[n_io_chans + 1]),
+                              &client.m_session, serialize);
+      }
+    } // for (idx in [0, n_clients))
+
+    /* After each benchmark we log our OS resource usage over it (see Res_usage): the client does the timing, and
+     * it reports the same for its side of each round; but we don't time anything, so ours is over the whole
+     * benchmark (every round, any throughput phase, and its prep such as deep copies).  Divide by the number of
+     * requests served for a per-request figure. */
+    auto usage_start = res_usage();
+    const auto log_usage = [&](const char* bench)
+    {
+      FLOW_LOG_INFO("Server-side resource usage over [" << bench << "] benchmark: "
+                    "[" << res_usage_desc(res_usage(true) - usage_start) << "].");
+      if (g_busy_poll != flow::Fine_duration::zero())
+      {
+        FLOW_LOG_INFO("Busy-poll: work found while spinning [" << g_busy_poll_stats.m_spin_hits << "] times; "
+                      "went to sleep [" << g_busy_poll_stats.m_fallbacks << "] times.");
+        g_busy_poll_stats = Busy_poll_stats();
+      }
+      usage_start = res_usage();
+    };
+
+    if (n_build_cost_msgs != 0)
+    {
+      // Benchmark 0 (optional).  No IPC at all: just building the message.
+      run_build_cost(&(*std_logger), clients.front().get(), n_build_cost_msgs);
+      log_usage("message construction");
+    }
+    run_capnp_over_raw(&(*std_logger), clients); // Benchmark 1.  capnp data transmission without Flow-IPC zero-copy.
+    log_usage("capnp over raw");
+    run_capnp_zero_copy(&(*std_logger), clients); // Benchmark 2.  Same but with it.
+    log_usage("capnp over Flow-IPC");
+    if (clients.front()->m_io_raw_aio)
+    {
+      run_io_overhead(&(*std_logger), clients); // Benchmark 3 (optional).  sync_io vs. async-I/O with tiny messages.
+      log_usage("sync_io vs. async-I/O");
+    }
+    if (clients.front()->m_ping_raw)
+    {
+      run_ping_pong(&(*std_logger), clients); // Benchmark 4 (optional).  Small messages of various sizes.
+      log_usage("ping-pong");
+    }
 
     FLOW_LOG_INFO("Exiting.");
   } // try
@@ -227,26 +498,110 @@ int main(int argc, char const * const * argv)
   return 0;
 } // main()
 
-void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
+void fill_rsp(perf_demo::schema::GetCacheRsp::Builder rsp_root, size_t total_sz)
+{
+  using flow::util::String_view;
+  using flow::util::ceil_div;
+  using std::min;
+
+  /* Small sizes (sweep mode) get just the 1 smaller file-part; otherwise it's N file-parts of this size.
+   * Exception: If the structured channel is heap-backed, a leaf (so, a file-part's data) must fit into 1 message of
+   * the transport; and in MQs those are only 8Ki.  (Also then a list -- such as the file-parts list -- must fit;
+   * so in that configuration the data size must be rather small: ~1Mi.  That's a limitation of non-zero-copy
+   * structured transmission; more or less the whole reason for zero-copy.) */
+#if (SHM_PROVIDER == SHM_PROVIDER_NONE) && (MQ_TYPE != MQ_TYPE_NONE)
+  constexpr size_t FILE_PART_SZ = 4 * 1024;
+#else
+  constexpr size_t FILE_PART_SZ = 16 * 1024;
+#endif
+  const auto file_part_sz = min(total_sz, FILE_PART_SZ);
+
+  auto file_parts_list = rsp_root.initFileParts(ceil_div(total_sz, file_part_sz));
+  for (size_t idx = 0; idx != file_parts_list.size(); ++idx)
+  {
+    auto file_part = file_parts_list[idx];
+    auto data = file_part.initData(file_part_sz);
+    for (size_t byte_idx = 0; byte_idx != file_part_sz; ++byte_idx)
+    {
+      data[byte_idx] = uint8_t(byte_idx % 256); // Dummy data... let's not just leave it as zeroes.
+    }
+    file_part.setDataSizeToVerify(file_part_sz);
+    /* Obviously a Boost string hash is not a cryptographically sound hash.  Fine for our purposes
+     * of sanity-checking that whatever the client received and accessed was at least mutually consistent nad
+     * not junk that accidentally didn't cause capnp to throw an exception during an accessor. */
+    file_part.setDataHashToVerify(boost::hash<String_view>()
+                                    (String_view(reinterpret_cast<const char*>(data.begin()), file_part_sz)));
+  }
+
+  /* Note total_sz is just a rough guide; we only count the GetCacheRsp.data field as "taking space";
+   * there's also nearby hash and size fields, plus capnp format overhead.  That said even with small
+   * sizes like 10kib it's a pretty decent estimate, it turns out.  (And it's certainly proportional at least.) */
+} // fill_rsp()
+
+std::shared_ptr<const Capnp_msg> capnp_msg(flow::log::Logger* logger_ptr, size_t total_sz)
+{
+  using flow::Flow_log_component;
+  using flow::util::ceil_div;
+
+  FLOW_LOG_SET_CONTEXT(logger_ptr, Flow_log_component::S_UNCAT);
+
+  if (std::find(g_total_szs.begin(), g_total_szs.end(), total_sz) == g_total_szs.end())
+  {
+    throw Runtime_error("Client requested a size we did not advertise.");
+  }
+  // else
+
+  /* Build it (unless already built) while holding the lock.  Only main() builds it while there's more than 1 event
+   * loop (see g_capnp_msgs_pinned); but the lookup and the map itself still need guarding. */
+  std::lock_guard<std::mutex> lock(g_capnp_msgs_mutex);
+  auto& weak_msg = g_capnp_msgs[total_sz];
+  if (auto msg = weak_msg.lock())
+  {
+    return msg;
+  }
+  // else
+
+  FLOW_LOG_INFO("Prep: Filling capnp MallocMessageBuilder "
+                "(rough size [" << ceil_div(total_sz, size_t(1024)) << " Ki]): START.");
+  auto msg = std::make_shared<Capnp_msg>();
+  fill_rsp(msg->m_builder.initRoot<perf_demo::schema::Body>().initGetCacheRsp(), total_sz);
+  msg->m_root = msg->m_builder.getRoot<perf_demo::schema::Body>().asReader();
+  msg->m_segs = msg->m_builder.getSegmentsForOutput();
+  msg->m_hdr.push_back(msg->m_segs.size());
+  for (const auto capnp_seg : msg->m_segs)
+  {
+    msg->m_hdr.push_back(capnp_seg.asBytes().size());
+  }
+  FLOW_LOG_INFO("Prep: Filling capnp MallocMessageBuilder: DONE.");
+
+  weak_msg = msg;
+  return msg;
+} // capnp_msg()
+
+void run_capnp_over_raw(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients)
 {
   using flow::Flow_log_component;
   using flow::log::Logger;
   using flow::log::Log_context;
+  using flow::log::Sev;
   using flow::util::ceil_div;
   using ::capnp::word;
   using boost::asio::post;
   using std::vector;
+  using std::unique_ptr;
+  using std::make_unique;
 
   /* While the code below is easy enough to follow, hopefully, we do need to explain why it's written like this at
    * all.  So firstly see main() which summarizes the goal here; in short we prep some data to send to client;
    * inform client we're ready for it to start its timing run; client issues request; we receive it; we send the
    * large response; the client receives it; spits out RTT for the timing run; and verifies the data appears to
    * be fine.  Now specifically in *this* run:
-   *   - "The data" is simply g_capnp_msg, a MallocMessageBuilder-backed (so, stored as N segments in heap, not SHM,
-   *     as arranged by capnp-supplied MallocMessageBuilder).  So it's already prepared back in main(): we needn't
-   *     do any more prep.
-   *   - The "send" and "receive" transport mechanism is a local stream socket (Unix domain socket), as prepared
-   *     for us by main() in *chan_ptr.
+   *   - "The data" is simply a g_capnp_msgs element, a MallocMessageBuilder-backed (so, stored as N segments in heap,
+   *     not SHM, as arranged by capnp-supplied MallocMessageBuilder).  So capnp_msg() prepares it (upon the 1st
+   *     request for that size, which the client doesn't time; or up-front with several clients); we needn't do any
+   *     more prep.
+   *   - The "send" and "receive" transport mechanism is a local stream socket (Unix domain socket) -- or, in an
+   *     MQ_TYPE != MQ_TYPE_NONE build, a pair of MQs -- as prepared for us by main() in *chan_ptr.
    *
    * The idea is we're simulating what a "vanilla" impl would do here: one where we have a big heap-stored
    * capnp tree, and we want to transmit it via a stream-socket and read it on the other side.
@@ -290,8 +645,8 @@ void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
    *     
    * @todo In retrospect there is one thing that would simplify particularly the main_cli.cpp side, that we could've
    * done here.  (The server would take a bit longer to run, outside the benchmarked section when preparing, but who
-   * cares?)  We could do capnp::messageToFlatArray() from g_capnp_msg (a slow copy) to encode the serialization into 1
-   * contiguous array according to capnp's seg-count/seg-counts/segs format; then send the whole thing as one buffer;
+   * cares?)  We could do capnp::messageToFlatArray() from g_capnp_msgs[] (a slow copy) to encode the serialization into
+   * 1 contiguous array according to capnp's seg-count/seg-counts/segs format; then send the whole thing as one buffer;
    * then in main_cli.cpp read it using FlatArrayMessageReader.  Then neither side would need to worry about
    * specifically sending the segment count and each segment's size -- just one big buffer.  Code would be simpler...
    * but less realistic -- probably -- as this involves an extra copy of the whole serialization on the sender side.
@@ -307,115 +662,189 @@ void run_capnp_over_raw(flow::log::Logger* logger_ptr, Channel_raw* chan_ptr)
   struct Algo :
     public Log_context
   {
+    Task_engine& m_asio;
     Channel_raw& m_chan;
     Error_code m_err_code;
     size_t m_sz;
     size_t m_n = 0;
+    // The size being served now (the client requests them 1 after another); and its data.  Null/0 before the 1st.
+    size_t m_total_sz = 0;
+    std::shared_ptr<const Capnp_msg> m_capnp_msg;
+    /* The client may request each size many times (see its --iterations); we log at INFO the 1st time for each size
+     * but at TRACE subsequently: logging to console synchronously is itself slow and would poison the timing. */
+    std::set<size_t> m_served_szs;
+    Sev m_sev = Sev::S_INFO;
 
-    Algo(Logger* logger_ptr, Channel_raw* chan_ptr) :
+    Algo(Logger* logger_ptr, size_t client_idx, Client* client_ptr) :
       Log_context(logger_ptr, Flow_log_component::S_UNCAT),
-      m_chan(*chan_ptr)
+      m_asio(*client_ptr->m_asio),
+      m_chan(client_ptr->m_chans[0])
     {
-      FLOW_LOG_INFO("-- RUN - capnp request/response over raw local-socket connection --");
+      FLOW_LOG_INFO("-- RUN - capnp request/response over raw " << transport_desc() << " connection "
+                    "(client [" << (client_idx + 1) << "]) --");
     }
 
     void start()
     {
       /* sync_io-pattern API: Drop-in our async-wait provider which is good ol' boost.asio .async_wait()
-       * over g_asio.  After this we can do sends and receives.  send()s in Flow-IPC are always synchronous,
-       * non-blocking, and never yield would-block.  Receives naturally are asynchronous; in sync_io pattern
-       * that means you give async_X() both a handler F to run later, if right now would-block results; and
-       * the out-args to set if the result is available synchronously right now.  So either one happens, or
-       * the other.  It's straightforward really, with one caveat to watch out for: avoid arbitrary-level
-       * recursive when reading looping data.  However here on server side we don't have any looping data
-       * to read (only send), so it's simple. */
-      m_chan.replace_event_wait_handles([]() -> auto { return Asio_handle(g_asio); });
+       * over m_asio (our client's event loop).  After this we can do sends and receives.  send()s in Flow-IPC are
+       * always synchronous, non-blocking, and never yield would-block.  Receives naturally are asynchronous; in
+       * sync_io pattern that means you give async_X() both a handler F to run later, if right now would-block
+       * results; and the out-args to set if the result is available synchronously right now.  So either one
+       * happens, or the other.  It's straightforward really, with one caveat to watch out for: avoid arbitrary-level
+       * recursive when reading looping data.  Here on server side we only read tiny requests, one after another;
+       * but there can be any number of them, so we do need to loop (not recurse) in read_requests(). */
+      m_chan.replace_event_wait_handles([this]() -> auto { return Asio_handle(m_asio); });
       m_chan.start_send_blob_ops(ev_wait);
       m_chan.start_receive_blob_ops(ev_wait);
 
       /* Send a dummy message to synchronize initialization.
        * It indicates we're for sure ready for this run to avoid any situation where, like,
        * client sends get-cache-request, but we're still setting something up after accepting the session;
-       * so we only send the response once we're ready to do that; but client has already started timing. */
-      FLOW_LOG_INFO("> Issuing handshake SYN for initialization sync.");
+       * so we only send the response once we're ready to do that; but client has already started timing.
+       *
+       * It's not entirely dummy: it advertises the sizes we have ready; the client will request each in turn.
+       * Each size is its own message; then 0 ends the list.  (Why not send them all in 1 message?  With SHM-enabled
+       * sessions over MQs, the MQ message size is quite small: sized for SHM handles only.) */
+      FLOW_LOG_INFO("> Issuing handshake SYN for initialization sync; "
+                    "advertising [" << g_total_szs.size() << "] response size(s).");
+      for (const auto& total_sz : g_total_szs)
+      {
+        m_chan.send_blob(Blob_const(&total_sz, sizeof(total_sz)));
+      }
+      m_n = 0;
       m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
 
+      read_requests();
+    }
+
+    void read_requests()
+    {
       /* Receive a dummy message as a request signal.  Technically we should expect an actual capnp-encoded
        * (albeit small) GetCacheReq here; but we'll accept any message; in the big benchmark this detail does not
-       * matter.  No need for all the extra code on both sides. */
-      FLOW_LOG_INFO("< Expecting get-cache request via tiny message.");
-      m_chan.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), &m_err_code, &m_sz,
-                                [&](const Error_code& err_code, size_t) { on_request(err_code); });
-      if (m_err_code != ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { on_request(m_err_code); }
+       * matter.  No need for all the extra code on both sides.  It does contain one thing: the requested
+       * size (one of the advertised ones); or 0 meaning the client is done with this benchmark. */
+      do
+      {
+        FLOW_LOG_WITH_CHECKING(m_sev, "< Expecting get-cache request via tiny message.");
+        m_chan.async_receive_blob(Blob_mutable(&m_n, sizeof(m_n)), &m_err_code, &m_sz,
+                                  [&](const Error_code& err_code, size_t) { on_request_async(err_code); });
+        if (m_err_code == ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { return; }
+      }
+      while (on_request(m_err_code));
+    }
+
+    void on_request_async(const Error_code& err_code)
+    {
+      if (on_request(err_code))
+      {
+        read_requests();
+      }
     }
 
-    void on_request(const Error_code& err_code)
+    bool on_request(const Error_code& err_code)
     {
       if (err_code) { throw Runtime_error(err_code, "run_capnp_over_raw():on_request()"); }
-      FLOW_LOG_INFO("= Got get-cache request.");
+      if (m_n == 0)
+      {
+        FLOW_LOG_INFO("= Got end-of-requests signal.");
+        m_capnp_msg.reset(); // Free it (unless another client is still on that size).
+        return false; // No more async-ops outstanding: this loop will run out of work.
+      }
+      // else
+
+      if (m_n != m_total_sz)
+      {
+        // Next size: let go of the previous one first (so it's freed, unless another client is still on it).
+        m_capnp_msg.reset();
+        m_capnp_msg = capnp_msg(get_logger(), m_n);
+        m_total_sz = m_n;
+      }
+      m_sev = m_served_szs.insert(m_n).second ? Sev::S_INFO : Sev::S_TRACE;
+      FLOW_LOG_WITH_CHECKING(m_sev,
+                             "= Got get-cache request (rough size [" << ceil_div(m_n, size_t(1024)) << " Ki]).");
 
       /* The format is like this:
-       *   - size_t - serialization's segment count
-       *   - [segment][segment]... where each [segment] is:
-       *     - size_t - segment size in bytes
-       *     - the segment: that many bytes
-       * BTW capnp's own format is not that different; but it has the seg-count, then the individual seg-sizes
-       * one after another, then the segments themselves one after another... plus the counts are 32-bits
-       * apparently.  @todo In retrospect the code on receiving side would've been somewhat simpler if we followed this
-       * header-then-segments technique... less state-switching back and forth arguably.  Live and learn!
+       *   - size_t - serialization's segment count (N)
+       *   - size_t[N] - each segment's size in bytes
+       *   - [segment][segment]...: the segments themselves, each that many bytes
+       * That's capnp's own format really, except its counts are 32-bits apparently.  (It used to be
+       * [seg size][segment][seg size][segment]...; but that's 1 more message -- and syscall on each side -- per
+       * segment, just for 8 bytes; and more state-switching on the receiving side.)  The header (count and sizes) is
+       * 1 buffer (Capnp_msg::m_hdr), hence 1 message; unless it exceeds send_blob_max_size(): that takes a few
+       * hundred segments; or a few over a SHM-handle-sized MQ.
        *
        * BTW you'll notice the characteristic escalation in segment sizes: by default MallocMessageBuilder
        * will size each successive segment as equal to the sum of all preceding segment sizes... exponential growth. */
 
-      const auto capnp_segs = g_capnp_msg.getSegmentsForOutput();
-      m_n = capnp_segs.size();
-      FLOW_LOG_INFO("> Sending get-cache response fragment: capnp segment count = [" << m_n << "].");
-      m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
-      FLOW_LOG_INFO("> Sending get-cache response fragments x N: [seg size, seg content...].");
+      const auto capnp_segs = m_capnp_msg->m_segs;
+      const auto& hdr = m_capnp_msg->m_hdr;
+      FLOW_LOG_WITH_CHECKING(m_sev, "> Sending get-cache response header: capnp segment count = "
+                                    "[" << capnp_segs.size() << "]; segment sizes.");
+      const auto chunk_max_sz = m_chan.send_blob_max_size();
+      send_chunked(Blob_const(hdr.data(), hdr.size() * sizeof(size_t)), chunk_max_sz);
+      FLOW_LOG_WITH_CHECKING(m_sev, "> Sending get-cache response fragments x N: [seg content...].");
 
       /* Essentially (through Flow-IPC unstructured-transport layer) mostly do a bunch ~64k ::write()s.
        * That's reasonably realistic.  (Technically Flow-IPC adds extra semantics on top; namely it preserves
        * message boundaries; so send_blob() <=> async_receive_blob(), 1-to-1.  We use that just fine; and
        * internally Flow-IPC will send a few more bytes in there, namely 2-byte message sizes, 1 per message; but
        * it's minor in the big picture.  Real enough, I say!) */
-      const auto chunk_max_sz = m_chan.send_blob_max_size();
       for (size_t idx = 0; idx != capnp_segs.size(); ++idx)
       {
         const auto capnp_seg = capnp_segs[idx].asBytes();
-        m_n = capnp_seg.size();
-        m_chan.send_blob(Blob_const(&m_n, sizeof(m_n)));
-
-        auto start = capnp_seg.begin();
-        do
-        {
-          const auto chunk_sz = std::min(chunk_max_sz, m_n);
-          m_chan.send_blob(Blob_const(start, chunk_sz));
-          start += chunk_sz;
-          m_n -= chunk_sz;
-        }
-        while (m_n != 0);
+        send_chunked(Blob_const(capnp_seg.begin(), capnp_seg.size()), chunk_max_sz);
         // It's e.g. 15 extra log lines; let's not poison timing with that unless console logger turned up to TRACE+.
         FLOW_LOG_TRACE("= Sent segment [" << (idx + 1) << "] of [" << capnp_segs.size() << "]; "
                        "segment serialization size (capnp-decided) = "
                        "[" << ceil_div(capnp_seg.size(), size_t(1024)) << " Ki].");
       }
-      FLOW_LOG_INFO("= Done.  Total allocated size = "
-                    "[" << ceil_div(g_capnp_msg.sizeInWords() * sizeof(word), size_t(1024 * 1024)) << " Mi].");
+      size_t total_sz = 0;
+      for (const auto capnp_seg : capnp_segs)
+      {
+        total_sz += capnp_seg.size() * sizeof(word);
+      }
+      FLOW_LOG_WITH_CHECKING(m_sev, "= Done.  Total allocated size = [" << ceil_div(total_sz, size_t(1024)) << " Ki].");
+      return true;
     } // on_request()
+
+    // Sends `blob` (not empty) as 1+ messages, in order, each as large as allowed; the client reassembles them.
+    void send_chunked(Blob_const blob, size_t chunk_max_sz)
+    {
+      auto start = static_cast<const uint8_t*>(blob.data());
+      auto n = blob.size();
+      do
+      {
+        const auto chunk_sz = std::min(chunk_max_sz, n);
+        m_chan.send_blob(Blob_const(start, chunk_sz));
+        start += chunk_sz;
+        n -= chunk_sz;
+      }
+      while (n != 0);
+    }
   }; // class Algo
 
-  Algo algo(logger_ptr, chan_ptr);
-  post(g_asio, [&]() { algo.start(); });
-  g_asio.run();
-  g_asio.restart();
+  /* 1 Algo per client, each on its client's event loop.  Each Algo runs out of async-ops once its client says it's
+   * done; so the loops simply run out of work, once all of their clients are done. */
+  vector<unique_ptr<Algo>> algos;
+  for (size_t idx = 0; idx != clients.size(); ++idx)
+  {
+    auto algo = algos.emplace_back(make_unique<Algo>(logger_ptr, idx, clients[idx].get())).get();
+    post(algo->m_asio, [algo]() { algo->start(); });
+  }
+  run_event_loops();
 } // run_capnp_over_raw()
 
-void run_capnp_zero_copy(flow::log::Logger* logger_ptr, Channel_struc* chan_ptr, Session* session_ptr)
+void run_capnp_zero_copy(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients)
 {
   using flow::Flow_log_component;
   using flow::log::Logger;
   using flow::log::Log_context;
+  using flow::log::Sev;
   using boost::asio::post;
+  using std::vector;
+  using std::unique_ptr;
+  using std::make_unique;
 
   /* And now we do just the same thing as run_capnp_over_raw()... except over full-on Flow-IPC, with zero-copy!
    * Obviously you'll see -- especially on the client side -- how much simpler it is.  And it'll be much, much, much
@@ -427,26 +856,57 @@ void run_capnp_zero_copy(flow::log::Logger* logger_ptr, Channel_struc* chan_ptr,
   struct Algo :
     public Log_context
   {
+    Task_engine& m_asio;
     Channel_struc& m_chan;
-    Session::Structured_msg_builder_config::Builder m_capnp_builder;
-    Channel_struc::Msg_out m_capnp_msg;
+    /* Key = size; value = the SHM-backed (unless --serialize=heap) deep-copy of that size's heap-backed gold copy
+     * (see capnp_msg()), which is what we actually send.  Each client gets its own deep-copies, in its session's
+     * SHM arena.  (The client's side of a session can only see its own session's arena.  With --serialize=app-shm
+     * that's not strictly so; but keep it simple.)  With 1 client: just the size being served now, made when the
+     * client first asks for it (it doesn't time that round).  With several: all of them, made up-front in the
+     * ctor (main thread, before the loops run), for the same reason as g_capnp_msgs_pinned: otherwise a deep copy
+     * from 1 client's event loop would delay the others on that loop mid-benchmark.  That's quite a bit of RAM with
+     * many clients and large sizes; see --sweep-max-mi. */
+    std::map<size_t, Channel_struc::Msg_out> m_capnp_msgs;
+    // See run_capnp_over_raw() counterpart.
+    std::set<size_t> m_served_szs;
+    Run_countdown& m_countdown;
 
-    Algo(Logger* logger_ptr, Channel_struc* chan_ptr, Session* session_ptr) :
+    Algo(Logger* logger_ptr, size_t client_idx, Client* client_ptr, Run_countdown* countdown_ptr) :
       Log_context(logger_ptr, Flow_log_component::S_UNCAT),
-      m_chan(*chan_ptr),
-      m_capnp_builder(session_ptr->session_shm_builder_config())
+      m_asio(*client_ptr->m_asio),
+      m_chan(*client_ptr->m_chan_struc),
+      m_countdown(*countdown_ptr)
     {
-      FLOW_LOG_INFO("-- RUN - zero-copy (SHM-backed) capnp request/response using Flow-IPC --");
+      FLOW_LOG_INFO("-- RUN - " << serialize_desc(client_ptr->m_serialize_via) << " capnp request/response "
+                    "using Flow-IPC (client [" << (client_idx + 1) << "]) --");
+
+      if (!g_capnp_msgs_pinned.empty())
+      {
+        for (const auto total_sz : g_total_szs)
+        {
+          prep(total_sz);
+        }
+      }
     }
 
-    void start()
+    // Deep-copies size total_sz's gold copy into m_capnp_msgs[total_sz].
+    void prep(size_t total_sz)
     {
-      FLOW_LOG_INFO("= Prep: Deep-copying heap-backed capnp message into Flow-IPC SHM-backed message: START.");
-      m_capnp_builder.payload_msg_builder()->setRoot(g_capnp_msg.getRoot<perf_demo::schema::Body>().asReader());
-      m_capnp_msg = Channel_struc::Msg_out(std::move(m_capnp_builder));
+      const auto gold = capnp_msg(get_logger(), total_sz);
+
+      FLOW_LOG_INFO("= Prep: Deep-copying heap-backed capnp message (rough size "
+                    "[" << flow::util::ceil_div(total_sz, size_t(1024)) << " Ki]) into Flow-IPC SHM-backed message: "
+                    "START.");
+      // Whatever backing the channel was set up with (session-scope SHM, app-scope SHM, or heap).
+      Channel_struc::Builder_config::Builder capnp_builder(m_chan.struct_builder_config());
+      capnp_builder.payload_msg_builder()->setRoot(gold->m_root);
+      m_capnp_msgs.emplace(total_sz, Channel_struc::Msg_out(std::move(capnp_builder)));
       FLOW_LOG_INFO("= Prep: Deep-copying heap-backed capnp message into Flow-IPC SHM-backed message: DONE.");
+    }
 
-      m_chan.replace_event_wait_handles([]() -> auto { return Asio_handle(g_asio); });
+    void start()
+    {
+      m_chan.replace_event_wait_handles([this]() -> auto { return Asio_handle(m_asio); });
       m_chan.start_ops(ev_wait);
       m_chan.start_and_poll([](const Error_code&) {});
 
@@ -454,42 +914,669 @@ void run_capnp_zero_copy(flow::log::Logger* logger_ptr, Channel_struc* chan_ptr,
       FLOW_LOG_INFO("> Issuing handshake SYN for initialization sync.");
       m_chan.send(m_chan.create_msg());
 
-      // Receive a dummy message as a request signal.
-      FLOW_LOG_INFO("< Expecting get-cache request.");
-      Channel_struc::Msg_in_ptr req;
-      m_chan.expect_msg(Channel_struc::Msg_which_in::GET_CACHE_REQ, &req,
-                        [&](Channel_struc::Msg_in_ptr&& req) { on_request(std::move(req)); });
-      if (req) { on_request(std::move(req)); }
+      /* Receive requests until the client says it's done.  (The sizes were already advertised in
+       * run_capnp_over_raw(), so no need to repeat that in the SYN above.) */
+      FLOW_LOG_INFO("< Expecting get-cache requests.");
+      Channel_struc::Msgs_in reqs;
+      m_chan.expect_msgs(Channel_struc::Msg_which_in::GET_CACHE_REQ, &reqs,
+                         [&](Channel_struc::Msg_in_ptr&& req) { on_request(std::move(req)); });
+      for (auto& req : reqs)
+      {
+        on_request(std::move(req));
+      }
     }
 
     void on_request(Channel_struc::Msg_in_ptr&& req)
     {
       /* Unlike run_capnp_over_raw(), where to avoid unnecessary code, we accepted any message as a request --
        * here we require GetCacheReq specifically (hence the Msg_which_in::GET_CACHE_REQ arg value above).
-       * We don't check its contents, but we might as well print it.  If you're keeping score we're doing some
-       * stuff here that run_capnp_over_raw() entirely skips... but good enough for our purposes, we think;
-       * at least we're not skewing results in Flow-IPC's favor. */
-      FLOW_LOG_INFO("= Got get-cache request [" << *req << "].");
-
-      FLOW_LOG_INFO("> Sending get-cache (quite large) response.");
-      m_chan.send(m_capnp_msg, req.get());
-      FLOW_LOG_INFO("= Done.");
-      g_asio.stop();
-
-      /* The .stop() is needed here, because struc::Channel is always reading all internally incoming messages ASAP;
-       * so it always has an .async_wait() outstanding.  Hence the .run() never runs out of work, unless we
-       * flip the g_asio internal "is-stopped" switch which causes it to in fact return the moment
-       * the .stop()ping task (function, such as this one) returns.  .stop() flips that switch. */
+       * We don't check its contents (other than the size), but we might as well print it.  If you're keeping score
+       * we're doing some stuff here that run_capnp_over_raw() entirely skips... but good enough for our purposes,
+       * we think; at least we're not skewing results in Flow-IPC's favor. */
+      const auto total_sz = req->body_root().getGetCacheReq().getFileSz();
+      if (total_sz == 0)
+      {
+        FLOW_LOG_INFO("= Got end-of-requests signal.");
+        // m_chan belongs to Client and outlives us: no more calls to our handler (it captures `this`).
+        m_chan.unexpect_msgs(Channel_struc::Msg_which_in::GET_CACHE_REQ);
+        m_capnp_msgs.clear();
+        m_countdown.client_done(); // The last one stops the loops (see Run_countdown for why that's needed).
+        return;
+      }
+      // else
+
+      const auto sev = m_served_szs.insert(total_sz).second ? Sev::S_INFO : Sev::S_TRACE;
+      FLOW_LOG_WITH_CHECKING(sev, "= Got get-cache request [" << *req << "].");
+      auto capnp_msg_it = m_capnp_msgs.find(total_sz);
+      if (capnp_msg_it == m_capnp_msgs.end())
+      {
+        // 1 client; next size: let go of the previous one first; then prep this one (the client doesn't time this).
+        m_capnp_msgs.clear();
+        prep(total_sz);
+        capnp_msg_it = m_capnp_msgs.begin();
+      }
+
+      FLOW_LOG_WITH_CHECKING(sev, "> Sending get-cache (possibly quite large) response.");
+      m_chan.send(capnp_msg_it->second, req.get());
+      FLOW_LOG_WITH_CHECKING(sev, "= Done.");
     } // on_request()
   }; // class Algo
 
-  Algo algo(logger_ptr, chan_ptr, session_ptr);
-  post(g_asio, [&]() { algo.start(); });
-  g_asio.run();
-  g_asio.restart();
-  /* These next 2 lines aren't really important; technically it's true that when we issue .stop() that'll prevent
-   * any already-queued handlers from running once the .stop()ping task `return`s, so this issues an extra .poll()
-   * to "flush" those, if any... but not block after that's done. */
-  g_asio.poll();
-  g_asio.restart();
+  Run_countdown countdown(clients.size());
+  vector<unique_ptr<Algo>> algos;
+  for (size_t idx = 0; idx != clients.size(); ++idx)
+  {
+    auto algo = algos.emplace_back(make_unique<Algo>(logger_ptr, idx, clients[idx].get(), &countdown)).get();
+    post(algo->m_asio, [algo]() { algo->start(); });
+  }
+  run_event_loops();
 } // run_capnp_zero_copy()
+
+void run_io_overhead(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients)
+{
+  using flow::Flow_log_component;
+  using flow::log::Logger;
+  using flow::log::Log_context;
+  using boost::asio::post;
+  using std::vector;
+  using std::unique_ptr;
+  using std::make_unique;
+
+  /* This one's different from the first 2: no large data; the point is the overhead of the API pattern itself.
+   * Each tiny request is echoed right back -- in each of the Io_variant ways in turn (see there), the client
+   * signaling the end of each variant with a 0 request -- using the same API pattern as the client for that variant.
+   * So the RTT difference the client sees includes both sides' overhead.  The client does the timing; but we log our
+   * context switches too, as we have our own thread(s) W in the async-I/O variants.  (getrusage() reports those for
+   * the whole process; so with --clients=K > 1 each client's numbers include the others'.  Take them with a grain of
+   * salt then.)
+   *
+   * All 4 variants' receives are set up at the start (the client only does 1 variant at a time anyway).  Unlike in
+   * run_capnp_over_raw(), the loop doesn't run out of work by itself: the sync_io struc::Channel always has an
+   * .async_wait() outstanding (see run_capnp_zero_copy()); so the last client to be done stops all the loops.  That's
+   * just as well: while waiting for the async-I/O guys' thread W to post() to it, the loop would have no work
+   * otherwise. */
+
+  struct Algo :
+    public Log_context
+  {
+    Task_engine& m_asio;
+    Channel_raw& m_raw_sio;
+    Channel_raw_aio& m_raw_aio;
+    Channel_struc& m_struc_sio;
+    Channel_struc_aio& m_struc_aio;
+    // The struc::Channel variants always respond with the same (empty) response; a Msg_out can be sent repeatedly.
+    std::optional<Channel_struc::Msg_out> m_struc_sio_rsp;
+    std::optional<Channel_struc_aio::Msg_out> m_struc_aio_rsp;
+    Error_code m_err_code;
+    size_t m_sz;
+    // Receive targets of the raw variants.  (Separate: both receives are outstanding at once.)
+    size_t m_n_sio = 0;
+    size_t m_n_aio = 0;
+    size_t m_n_variants_done = 0;
+    uint64_t m_n_echoes = 0;
+    Ctx_switches m_ctx_switches_start;
+    Run_countdown& m_countdown;
+
+    Algo(Logger* logger_ptr, size_t client_idx, Client* client_ptr, Run_countdown* countdown_ptr) :
+      Log_context(logger_ptr, Flow_log_component::S_UNCAT),
+      m_asio(*client_ptr->m_asio),
+      m_raw_sio(client_ptr->m_cli_chans[size_t(Io_variant::S_RAW_SYNC_IO)]),
+      m_raw_aio(*client_ptr->m_io_raw_aio),
+      m_struc_sio(*client_ptr->m_io_struc_sio),
+      m_struc_aio(*client_ptr->m_io_struc_aio),
+      m_countdown(*countdown_ptr)
+    {
+      FLOW_LOG_INFO("-- RUN - sync_io versus async-I/O overhead: tiny request/response echo "
+                    "(client [" << (client_idx + 1) << "]) --");
+
+      m_struc_sio_rsp.emplace(m_struc_sio.create_msg());
+      m_struc_sio_rsp->body_root()->initGetCacheRsp();
+      m_struc_aio_rsp.emplace(m_struc_aio.create_msg());
+      m_struc_aio_rsp->body_root()->initGetCacheRsp();
+    }
+
+    void start()
+    {
+      m_raw_sio.replace_event_wait_handles([this]() -> auto { return Asio_handle(m_asio); });
+      m_raw_sio.start_send_blob_ops(ev_wait);
+      m_raw_sio.start_receive_blob_ops(ev_wait);
+      m_struc_sio.replace_event_wait_handles([this]() -> auto { return Asio_handle(m_asio); });
+      m_struc_sio.start_ops(ev_wait);
+      m_struc_sio.start_and_poll([](const Error_code&) {});
+      m_struc_aio.start([](const Error_code&) {});
+
+      FLOW_LOG_INFO("< Expecting tiny requests, in each of [" << N_IO_VARIANTS << "] ways in turn.");
+      m_ctx_switches_start = ctx_switches();
+
+      read_raw_sio();
+      read_raw_aio();
+
+      Channel_struc::Msgs_in reqs;
+      m_struc_sio.expect_msgs(Channel_struc::Msg_which_in::GET_CACHE_REQ, &reqs,
+                              [this](Channel_struc::Msg_in_ptr&& req) { on_struc_sio_request(std::move(req)); });
+      for (auto& req : reqs)
+      {
+        on_struc_sio_request(std::move(req));
+      }
+
+      m_struc_aio.expect_msgs(Channel_struc_aio::Msg_which_in::GET_CACHE_REQ,
+                              [this](Channel_struc_aio::Msg_in_ptr&& req)
+      {
+        // We're in thread W.  As is typical, do the real work back in our event loop's thread.
+        post(m_asio, [this, req = std::move(req)]() mutable { on_struc_aio_request(std::move(req)); });
+      });
+    } // start()
+
+    // sync_io: same looping-not-recursing technique as in run_capnp_over_raw().
+    void read_raw_sio()
+    {
+      do
+      {
+        m_raw_sio.async_receive_blob(Blob_mutable(&m_n_sio, sizeof(m_n_sio)), &m_err_code, &m_sz,
+                                     [this](const Error_code& err_code, size_t)
+        {
+          if (on_raw_sio_request(err_code))
+          {
+            read_raw_sio();
+          }
+        });
+        if (m_err_code == ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { return; }
+      }
+      while (on_raw_sio_request(m_err_code));
+    }
+
+    // Returns `true` if and only if there's more to receive.
+    bool on_raw_sio_request(const Error_code& err_code)
+    {
+      if (err_code) { throw Runtime_error(err_code, "run_io_overhead():on_raw_sio_request()"); }
+      if (m_n_sio == 0)
+      {
+        on_variant_done(Io_variant::S_RAW_SYNC_IO);
+        return false;
+      }
+      // else
+      m_raw_sio.send_blob(Blob_const(&m_n_sio, sizeof(m_n_sio)));
+      ++m_n_echoes;
+      return true;
+    }
+
+    // async-I/O: the handler is invoked from thread W; so post() onto our loop.  No recursion worries here.
+    void read_raw_aio()
+    {
+      m_raw_aio.async_receive_blob(Blob_mutable(&m_n_aio, sizeof(m_n_aio)), [this](const Error_code& err_code, size_t)
+      {
+        if (err_code == ipc::transport::error::Code::S_OBJECT_SHUTDOWN_ABORTED_COMPLETION_HANDLER)
+        {
+          return; // Channel is being destroyed; we're shutting down anyway.
+        }
+        // else
+        post(m_asio, [this, err_code]() { on_raw_aio_request(err_code); });
+      });
+    }
+
+    void on_raw_aio_request(const Error_code& err_code)
+    {
+      if (err_code) { throw Runtime_error(err_code, "run_io_overhead():on_raw_aio_request()"); }
+      if (m_n_aio == 0)
+      {
+        on_variant_done(Io_variant::S_RAW_ASYNC_IO);
+        return;
+      }
+      // else
+      m_raw_aio.send_blob(Blob_const(&m_n_aio, sizeof(m_n_aio)));
+      ++m_n_echoes;
+      read_raw_aio();
+    }
+
+    void on_struc_sio_request(Channel_struc::Msg_in_ptr&& req)
+    {
+      if (req->body_root().getGetCacheReq().getFileSz() == 0)
+      {
+        /* The channel belongs to Client and outlives us; so make sure it won't invoke our handler (capturing `this`)
+         * anymore, should anything else arrive.  Same in the other benchmarks' struc::Channel handlers. */
+        m_struc_sio.unexpect_msgs(Channel_struc::Msg_which_in::GET_CACHE_REQ);
+        on_variant_done(Io_variant::S_STRUC_SYNC_IO);
+        return;
+      }
+      // else
+      m_struc_sio.send(*m_struc_sio_rsp, req.get());
+      ++m_n_echoes;
+    }
+
+    void on_struc_aio_request(Channel_struc_aio::Msg_in_ptr&& req)
+    {
+      if (req->body_root().getGetCacheReq().getFileSz() == 0)
+      {
+        m_struc_aio.unexpect_msgs(Channel_struc_aio::Msg_which_in::GET_CACHE_REQ); // See on_struc_sio_request().
+        on_variant_done(Io_variant::S_STRUC_ASYNC_IO);
+        return;
+      }
+      // else
+      m_struc_aio.send(*m_struc_aio_rsp, req.get());
+      ++m_n_echoes;
+    }
+
+    void on_variant_done(Io_variant variant)
+    {
+      const auto now = ctx_switches();
+      FLOW_LOG_INFO("= [" << io_variant_desc(variant) << "]: echoed [" << m_n_echoes << "] requests; meanwhile this "
+                    "process context-switched [" << (now.m_voluntary - m_ctx_switches_start.m_voluntary) << "] times "
+                    "voluntarily, [" << (now.m_involuntary - m_ctx_switches_start.m_involuntary) << "] involuntarily.");
+      m_n_echoes = 0;
+      m_ctx_switches_start = now;
+
+      if (++m_n_variants_done == N_IO_VARIANTS)
+      {
+        m_countdown.client_done();
+      }
+    }
+  }; // class Algo
+
+  Run_countdown countdown(clients.size());
+  vector<unique_ptr<Algo>> algos;
+  for (size_t idx = 0; idx != clients.size(); ++idx)
+  {
+    auto algo = algos.emplace_back(make_unique<Algo>(logger_ptr, idx, clients[idx].get(), &countdown)).get();
+    post(algo->m_asio, [algo]() { algo->start(); });
+  }
+  run_event_loops();
+} // run_io_overhead()
+
+void run_ping_pong(flow::log::Logger* logger_ptr, const std::vector<std::unique_ptr<Client>>& clients)
+{
+  using flow::Flow_log_component;
+  using flow::log::Logger;
+  using flow::log::Log_context;
+  using boost::asio::post;
+  using std::vector;
+  using std::unique_ptr;
+  using std::make_unique;
+
+  /* Like run_io_overhead(), an echo server; but the client sends blobs of various (small-ish) sizes: each of
+   * PING_PONG_SZS (that the channel can carry) in turn; first over the raw channel, then over the structured one.
+   * We echo each right back, same size.  The client signals the end with a PING_PONG_END_SZ-byte blob (on either
+   * channel).  Since the sizes are known up-front we pre-build the structured responses, as in
+   * run_capnp_zero_copy().  Also as there: the last client to be done stops the loops. */
+
+  struct Algo :
+    public Log_context
+  {
+    Task_engine& m_asio;
+    Channel_raw& m_raw;
+    Channel_struc& m_struc;
+    // Key = blob size; value = response with a blob of that size.
+    std::map<size_t, Channel_struc::Msg_out> m_struc_rsps;
+    Error_code m_err_code;
+    size_t m_sz;
+    Blob m_buf;
+    size_t m_n_done = 0;
+    Run_countdown& m_countdown;
+
+    Algo(Logger* logger_ptr, size_t client_idx, Client* client_ptr, Run_countdown* countdown_ptr) :
+      Log_context(logger_ptr, Flow_log_component::S_UNCAT),
+      m_asio(*client_ptr->m_asio),
+      m_raw(*client_ptr->m_ping_raw),
+      m_struc(*client_ptr->m_ping_struc),
+      m_buf(PING_PONG_SZS.back()),
+      m_countdown(*countdown_ptr)
+    {
+      FLOW_LOG_INFO("-- RUN - small-message ping-pong echo (client [" << (client_idx + 1) << "]) --");
+
+      for (const auto sz : PING_PONG_SZS)
+      {
+        if (ping_pong_sz_ok(sz, true, m_raw.send_blob_max_size()))
+        {
+          auto& rsp = m_struc_rsps.emplace(sz, m_struc.create_msg()).first->second;
+          auto data = rsp.body_root()->initPingPong(sz);
+          std::fill(data.begin(), data.end(), uint8_t(sz));
+        }
+      }
+    }
+
+    void start()
+    {
+      m_raw.replace_event_wait_handles([this]() -> auto { return Asio_handle(m_asio); });
+      m_raw.start_send_blob_ops(ev_wait);
+      m_raw.start_receive_blob_ops(ev_wait);
+      m_struc.replace_event_wait_handles([this]() -> auto { return Asio_handle(m_asio); });
+      m_struc.start_ops(ev_wait);
+      m_struc.start_and_poll([](const Error_code&) {});
+
+      FLOW_LOG_INFO("< Expecting pings: raw, then structured.");
+      read_raw();
+
+      Channel_struc::Msgs_in reqs;
+      m_struc.expect_msgs(Channel_struc::Msg_which_in::PING_PONG, &reqs,
+                          [this](Channel_struc::Msg_in_ptr&& req) { on_struc_request(std::move(req)); });
+      for (auto& req : reqs)
+      {
+        on_struc_request(std::move(req));
+      }
+    }
+
+    // Same looping-not-recursing technique as in run_capnp_over_raw().
+    void read_raw()
+    {
+      do
+      {
+        m_raw.async_receive_blob(Blob_mutable(m_buf.data(), m_buf.size()), &m_err_code, &m_sz,
+                                 [this](const Error_code& err_code, size_t sz)
+        {
+          if (on_raw_request(err_code, sz))
+          {
+            read_raw();
+          }
+        });
+        if (m_err_code == ipc::transport::error::Code::S_SYNC_IO_WOULD_BLOCK) { return; }
+      }
+      while (on_raw_request(m_err_code, m_sz));
+    }
+
+    // Returns `true` if and only if there's more to receive.
+    bool on_raw_request(const Error_code& err_code, size_t sz)
+    {
+      if (err_code) { throw Runtime_error(err_code, "run_ping_pong():on_raw_request()"); }
+      if (sz == PING_PONG_END_SZ)
+      {
+        on_done("raw");
+        return false;
+      }
+      // else
+      m_raw.send_blob(Blob_const(m_buf.data(), sz));
+      return true;
+    }
+
+    void on_struc_request(Channel_struc::Msg_in_ptr&& req)
+    {
+      const auto sz = req->body_root().getPingPong().size();
+      if (sz == PING_PONG_END_SZ)
+      {
+        m_struc.unexpect_msgs(Channel_struc::Msg_which_in::PING_PONG); // As in run_capnp_zero_copy().
+        on_done("structured");
+        return;
+      }
+      // else
+      const auto rsp_it = m_struc_rsps.find(sz);
+      if (rsp_it == m_struc_rsps.end())
+      {
+        throw Runtime_error("Client pinged with a size we cannot echo over a structured channel.");
+      }
+      // else
+      m_struc.send(rsp_it->second, req.get());
+    }
+
+    void on_done(const char* what)
+    {
+      FLOW_LOG_INFO("= Got end-of-pings signal ([" << what << "]).");
+      if (++m_n_done == N_PING_PONG_CHANS)
+      {
+        m_countdown.client_done();
+      }
+    }
+  }; // class Algo
+
+  Run_countdown countdown(clients.size());
+  vector<unique_ptr<Algo>> algos;
+  for (size_t idx = 0; idx != clients.size(); ++idx)
+  {
+    auto algo = algos.emplace_back(make_unique<Algo>(logger_ptr, idx, clients[idx].get(), &countdown)).get();
+    post(algo->m_asio, [algo]() { algo->start(); });
+  }
+  run_event_loops();
+} // run_ping_pong()
+
+void run_build_cost(flow::log::Logger* logger_ptr, Client* client_ptr, size_t n_msgs)
+{
+  using flow::Flow_log_component;
+  using flow::util::ceil_div;
+  using boost::chrono::duration_cast;
+  using boost::chrono::nanoseconds;
+  using std::array;
+  using std::optional;
+  using std::setw;
+  using std::setprecision;
+  using std::fixed;
+
+  FLOW_LOG_SET_CONTEXT(logger_ptr, Flow_log_component::S_UNCAT);
+
+  /* The zero-copy benchmark (run_capnp_zero_copy()) deep-copies a pre-built message into the SHM-backed builder
+   * up-front, untimed; and only then times the transmission.  In a real server, though, the response is built anew
+   * for each request; so the construction is itself (a big) part of the hot path, and that benchmark says nothing
+   * about it.  Hence this one: build the same GetCacheRsp (via the same fill_rsp()) N times, each time in a fresh
+   * MessageBuilder of each of the following kinds; and time it.  Plus time the deep copy itself: so the
+   * "build in heap, then copy into SHM" approach costs rows S_CAPNP_HEAP + S_FLOW_IPC_DEEP_COPY combined, versus
+   * S_FLOW_IPC for building directly in SHM.
+   *
+   * Timed: constructing the builder plus filling it in.  Timed separately (column "teardown"): destroying it; as in
+   * real life that happens later, off the request's path (the message lives on until sent -- and, with SHM, until
+   * the opposing side is done with it too); but it's still CPU spent per message.  Also reported: how many
+   * segments capnp asked the builder for (each one is an allocation from its backing memory: SHM with a SHM-backed
+   * builder, else the heap; a SHM builder also keeps a small segment list in SHM, 1 more allocation per segment
+   * or so); and how many bytes ended up written into them (i.e., touched: the serialization size; a deep copy
+   * also reads as many from the source).
+   *
+   * It all happens right here in the main thread before the transmission benchmarks begin (the client just waits
+   * for those meanwhile); and uses the 1st client's session (for the SHM arena, and the heap-builder config that
+   * suits its channels).
+   *
+   * S_CAPNP_HEAP_RECYCLED is what a segment pool would buy a heap builder: the same MallocMessageBuilder, but given
+   * (as its 1st segment) a buffer, large enough for the whole message, that we reuse for every message; so there's
+   * no allocation at all (segs = 1).  Its price is that capnp requires that buffer zeroed; the builder re-zeroes it
+   * in its destructor: that's in its teardown time. */
+  enum class Way
+  {
+    S_CAPNP_HEAP,
+    S_CAPNP_HEAP_RECYCLED,
+    S_HEAP_FIXED,
+    S_FLOW_IPC,
+    S_FLOW_IPC_DEEP_COPY
+  };
+  constexpr size_t N_WAYS = 5;
+
+  struct Result
+  {
+    Histogram m_build_times;
+    Histogram m_teardown_times;
+    size_t m_n_segs = 0;
+    size_t m_n_bytes = 0;
+  };
+
+  const auto way_desc = [](Way way) -> std::string
+  {
+    switch (way)
+    {
+    case Way::S_CAPNP_HEAP:
+      return "capnp::MallocMessageBuilder";
+    case Way::S_CAPNP_HEAP_RECYCLED:
+      return "MallocMessageBuilder, recycled";
+    case Way::S_HEAP_FIXED:
+      return "Heap_fixed_builder";
+    case Way::S_FLOW_IPC:
+      return "Flow-IPC builder";
+    case Way::S_FLOW_IPC_DEEP_COPY:
+      return "Flow-IPC builder, deep copy";
+    }
+    assert(false);
+    return "";
+  };
+  const auto to_nsec = [](flow::Fine_duration dur) -> double
+  {
+    return double(duration_cast<nanoseconds>(dur).count());
+  };
+
+  auto& client = *client_ptr;
+  auto& chan = *client.m_chan_struc;
+  const auto heap_fixed_cfg = client.m_session.heap_fixed_builder_config();
+
+  FLOW_LOG_INFO("-- RUN - message construction cost; [" << n_msgs << "] messages per size per builder; "
+                "Flow-IPC builder is " << serialize_desc(client.m_serialize_via) << " --");
+  FLOW_LOG_INFO("Build times in usec; teardown = mean time to destroy the builder (usec; not in the build times); "
+                "ns/part = mean build time per GetCacheRsp.FilePart; "
+                "ratio = mean build time versus " << way_desc(Way::S_CAPNP_HEAP) << ": ");
+  FLOW_LOG_INFO(setw(12) << "size (ki)" << " | " << setw(32) << "builder" << " | " << setw(10) << "p50" << " | "
+                << setw(10) << "mean" << " | " << setw(10) << "teardown" << " | " << setw(8) << "ns/part" << " | "
+                << setw(8) << "segs" << " | " << setw(12) << "bytes" << " | " << setw(6) << "ratio");
+
+  for (const auto total_sz : g_total_szs)
+  {
+    // Prepped now (untimed); freed at the end of this iteration.
+    const auto gold = capnp_msg(logger_ptr, total_sz);
+    const auto src_root = gold->m_root;
+    const auto n_file_parts = src_root.getGetCacheRsp().getFileParts().size();
+    // For S_CAPNP_HEAP_RECYCLED.  Some slack: the gold copy's segments (hence their padding) may differ.
+    auto recycled_seg = kj::heapArray<::capnp::word>(src_root.totalSize().wordCount * 5 / 4 + 1024);
+    std::memset(recycled_seg.begin(), 0, recycled_seg.size() * sizeof(::capnp::word));
+
+    array<Result, N_WAYS> results;
+    for (size_t msg_idx = 0; msg_idx != n_msgs; ++msg_idx)
+    {
+      // Interleave the ways: so any drift over time (other load, CPU frequency) affects them all alike.
+      for (size_t way_idx = 0; way_idx != N_WAYS; ++way_idx)
+      {
+        const auto way = Way(way_idx);
+        auto& result = results[way_idx];
+        optional<Capnp_heap_engine> capnp_heap_builder;
+        optional<ipc::transport::struc::Heap_fixed_builder> heap_fixed_builder;
+        optional<Channel_struc::Builder_config::Builder> flow_ipc_builder;
+
+        const auto start = flow::Fine_clock::now();
+        ::capnp::MessageBuilder* capnp_msg;
+        if (way == Way::S_CAPNP_HEAP)
+        {
+          capnp_msg = &capnp_heap_builder.emplace();
+        }
+        else if (way == Way::S_CAPNP_HEAP_RECYCLED)
+        {
+          capnp_msg = &capnp_heap_builder.emplace(recycled_seg.asPtr());
+        }
+        else if (way == Way::S_HEAP_FIXED)
+        {
+          capnp_msg = heap_fixed_builder.emplace(heap_fixed_cfg).payload_msg_builder();
+        }
+        else
+        {
+          // Whatever backing the channel was set up with, as in run_capnp_zero_copy().
+          capnp_msg = flow_ipc_builder.emplace(chan.struct_builder_config()).payload_msg_builder();
+        }
+
+        if (way == Way::S_FLOW_IPC_DEEP_COPY)
+        {
+          capnp_msg->setRoot(src_root);
+        }
+        else
+        {
+          fill_rsp(capnp_msg->initRoot<perf_demo::schema::Body>().initGetCacheRsp(), total_sz);
+        }
+        const auto build_time = flow::Fine_clock::now() - start;
+
+        // Same every time (same data, same builder); no need to accumulate.
+        const auto segs = capnp_msg->getSegmentsForOutput();
+        result.m_n_segs = segs.size();
+        result.m_n_bytes = 0;
+        for (const auto seg : segs)
+        {
+          result.m_n_bytes += seg.size() * sizeof(::capnp::word);
+        }
+
+        // Only 1 of these is non-empty.  (S_CAPNP_HEAP_RECYCLED: this re-zeroes recycled_seg[] for the next one.)
+        const auto teardown_start = flow::Fine_clock::now();
+        capnp_heap_builder.reset();
+        heap_fixed_builder.reset();
+        flow_ipc_builder.reset();
+        result.m_teardown_times.record(flow::Fine_clock::now() - teardown_start);
+        result.m_build_times.record(build_time);
+      } // for (way_idx)
+    } // for (msg_idx)
+
+    const double heap_mean = to_nsec(results[size_t(Way::S_CAPNP_HEAP)].m_build_times.mean());
+    for (size_t way_idx = 0; way_idx != N_WAYS; ++way_idx)
+    {
+      const auto& result = results[way_idx];
+      const double mean = to_nsec(result.m_build_times.mean());
+      FLOW_LOG_INFO(setw(12) << ceil_div(total_sz, size_t(1024)) << " | "
+                    << setw(32) << way_desc(Way(way_idx)) << " | " << setw(10) << fixed << setprecision(2)
+                    << (to_nsec(result.m_build_times.percentile(50)) / 1000) << " | "
+                    << setw(10) << (mean / 1000) << " | "
+                    << setw(10) << (to_nsec(result.m_teardown_times.mean()) / 1000) << " | "
+                    << setw(8) << setprecision(1) << (mean / double(n_file_parts)) << " | "
+                    << setw(8) << result.m_n_segs << " | " << setw(12) << result.m_n_bytes << " | "
+                    << setw(6) << setprecision(2) << ((heap_mean == 0) ? 0 : (mean / heap_mean)));
+    }
+
+    const double copy_mean = to_nsec(results[size_t(Way::S_FLOW_IPC_DEEP_COPY)].m_build_times.mean());
+    const double direct_mean = to_nsec(results[size_t(Way::S_FLOW_IPC)].m_build_times.mean());
+    FLOW_LOG_INFO(setw(12) << ceil_div(total_sz, size_t(1024)) << " | build in heap + deep copy = ["
+                  << fixed << setprecision(2) << ((heap_mean + copy_mean) / 1000) << " usec]; "
+                  "build directly = [" << (direct_mean / 1000) << " usec].");
+  } // for (total_sz : g_total_szs)
+} // run_build_cost()
+
+void run_event_loops()
+{
+  using std::exception_ptr;
+  using std::thread;
+  using std::vector;
+
+  /* g_asios[0] is run from this thread; the rest (if any) each from a new thread.  If a task throws, in this thread
+   * it would simply propagate (fine: main() reports it and exits); in another thread it would std::terminate()
+   * the whole thing with no message; so we carry it over and rethrow it here instead. */
+  vector<exception_ptr> excs(g_asios.size());
+  vector<Busy_poll_stats> busy_poll_stats(g_asios.size());
+  vector<thread> threads;
+  for (size_t idx = 1; idx != g_asios.size(); ++idx)
+  {
+    threads.emplace_back([idx, &excs, &busy_poll_stats]()
+    {
+      try
+      {
+        run_event_loop(g_asios[idx].get(), g_busy_poll, &busy_poll_stats[idx]);
+      }
+      catch (...)
+      {
+        excs[idx] = std::current_exception();
+        for (auto& asio : g_asios)
+        {
+          asio->stop(); // No point continuing.
+        }
+      }
+    });
+  }
+  try
+  {
+    run_event_loop(g_asios.front().get(), g_busy_poll, &busy_poll_stats.front());
+  }
+  catch (...)
+  {
+    excs.front() = std::current_exception();
+    for (auto& asio : g_asios)
+    {
+      asio->stop();
+    }
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  for (const auto& stats : busy_poll_stats)
+  {
+    g_busy_poll_stats.m_spin_hits += stats.m_spin_hits;
+    g_busy_poll_stats.m_fallbacks += stats.m_fallbacks;
+  }
+  for (const auto& exc : excs)
+  {
+    if (exc)
+    {
+      std::rethrow_exception(exc);
+    }
+  }
+
+  for (auto& asio : g_asios)
+  {
+    asio->restart();
+    /* These next 2 lines aren't really important; technically it's true that when we issue .stop() that'll prevent
+     * any already-queued handlers from running once the .stop()ping task `return`s, so this issues an extra .poll()
+     * to "flush" those, if any... but not block after that's done. */
+    asio->poll();
+    asio->restart();
+  }
+} // run_event_loops()
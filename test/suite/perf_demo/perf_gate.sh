@@ -0,0 +1,233 @@
+#!/bin/sh
+
+# Flow-IPC
+# Copyright 2023 Akamai Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in
+# compliance with the License.  You may obtain a copy
+# of the License at
+#
+#   https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in
+# writing, software distributed under the License is
+# distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+# CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing
+# permissions and limitations under the License.
+
+# Perf regression gate: runs the given perf_demo srv/cli pair(s), one after another, having the cli save its results
+# (--csv); then compares those with a stored baseline (1 file per pair); and exits non-zero if anything regressed
+# beyond its tolerance.  The idea: record a baseline (--record) on a given machine with a known-good Flow-IPC; then,
+# upon upgrading, run this again on the same machine.  (Comparing results from different machines is not meaningful.)
+#
+# Usage (from the dir where the perf_demo_*.exec live; e.g., via the perf_demo_gate[_record] CMake targets or ctest):
+#   [GATE_SRV_ARGS=...] [GATE_CLI_ARGS=...] [GATE_RUNS=<N>] [GATE_TOLERANCE_PCT=<N>] \
+#     ./perf_gate.sh [--record] <baseline dir> <variant>...
+# where each <variant> names a pair, e.g., `shm_classic` for perf_demo_{srv|cli}_shm_classic.exec.
+#
+# Each pair is run GATE_RUNS times (default 3); each metric's result is the median of those runs.  (1 run's p50 can
+# be off by quite a bit, e.g., if something else woke up meanwhile; the median of several is much steadier.)
+#
+# With --record the results become the pair's baseline (replacing any existing one; but keeping its 3rd column, see
+# below); and that's all.  Otherwise, if a pair has no baseline, that's an error (nothing to compare against); but
+# if nothing else went wrong, the exit code is then SKIP_EXIT (77), which ctest reports as a skipped test.
+#
+# What's compared: the metrics whose keys end in rtt_p50_usec or one_way_p50_usec (lower is better), or
+# tput_msgs_per_sec (higher is better), with a tolerance of GATE_TOLERANCE_PCT percent (default 25).  To change that
+# for a given metric, or to gate another one (any *_usec or *_per_sec), add a 3rd column to its row in the baseline
+# file: the tolerance in percent; or `-` to not gate it.
+
+# Exit immediately if any command has a non-zero exit status.
+set -e
+
+RECORD=0
+if [ "$1" = "--record" ]; then
+  RECORD=1
+  shift
+fi
+if [ "$#" -lt 2 ]; then
+  echo "Usage: $0 [--record] <baseline dir> <variant>..." >&2
+  exit 2
+fi
+
+BASELINE_DIR=$1
+shift
+OUT_DIR=gate_results
+SRV_WAIT_SECS=30
+SKIP_EXIT=77
+GATE_SRV_ARGS=${GATE_SRV_ARGS-1}
+if [ -z "${GATE_CLI_ARGS+set}" ]; then
+  GATE_CLI_ARGS="--iterations=2000 --io-overhead=5000"
+fi
+GATE_RUNS=${GATE_RUNS-3}
+GATE_TOLERANCE_PCT=${GATE_TOLERANCE_PCT-25}
+
+rm -rf "$OUT_DIR"
+mkdir -p "$OUT_DIR" "$BASELINE_DIR"
+
+# Runs 1 srv/cli pair ($1 = variant) once ($2 = which run); the cli saves its results to $OUT_DIR/$1.$2.csv.
+run_one()
+{
+  srv="./perf_demo_srv_$1.exec"
+  cli="./perf_demo_cli_$1.exec"
+  out="$OUT_DIR/$1.$2"
+
+  if [ ! -x "$srv" ] || [ ! -x "$cli" ]; then
+    echo "[$1]: executables not found (must run from their dir)." >&2
+    return 1
+  fi
+
+  # shellcheck disable=SC2086 # We want GATE_SRV_ARGS/GATE_CLI_ARGS word-split.
+  "$srv" $GATE_SRV_ARGS > "$out.srv.out" 2>&1 &
+  srv_pid=$!
+
+  waited=0
+  while ! grep -q "You can now invoke" "$out.srv.out"; do
+    if ! kill -0 "$srv_pid" 2> /dev/null || [ "$waited" -ge "$SRV_WAIT_SECS" ]; then
+      break
+    fi
+    sleep 1
+    waited=$((waited + 1))
+  done
+
+  # shellcheck disable=SC2086
+  if ! "$cli" $GATE_CLI_ARGS --csv="$out.csv" > "$out.cli.out" 2>&1; then
+    kill "$srv_pid" 2> /dev/null || true
+    wait "$srv_pid" || true
+    echo "[$1]: client failed; see [$out.cli.out]." >&2
+    return 1
+  fi
+  if ! wait "$srv_pid"; then
+    echo "[$1]: server failed; see [$out.srv.out]." >&2
+    return 1
+  fi
+}
+
+# Combines the results of runs $3... into $2: for each *_usec and *_per_sec metric its median value; for the rest
+# (e.g., the build configuration) the 1st run's row.  $1 is the existing baseline (or /dev/null): its 3rd column
+# (see top comment), if any, is carried over for the metrics.
+combine()
+{
+  old=$1
+  dst=$2
+  shift 2
+  awk -F, '
+    FILENAME == ARGV[1] { if ((NF >= 3) && ($1 ~ /(_usec|_per_sec)$/)) { tol[$1] = $3 }; next }
+    FNR == 1 { if (!hdr) { hdr = $0 }; next }
+    {
+      if (!($1 in row)) { row[$1] = $0; order[++n] = $1 }
+      if ($1 ~ /(_usec|_per_sec)$/) { vals[$1, ++cnt[$1]] = $2 + 0 }
+    }
+    END {
+      print hdr
+      for (i = 1; i <= n; ++i) {
+        key = order[i]
+        line = row[key]
+        if (key in cnt) {
+          # Insertion-sort its values; then take the middle one (or the mean of the middle 2).
+          m = cnt[key]
+          for (j = 1; j <= m; ++j) { v[j] = vals[key, j] }
+          for (j = 2; j <= m; ++j) {
+            x = v[j]
+            for (k = j - 1; (k >= 1) && (v[k] > x); --k) { v[k + 1] = v[k] }
+            v[k + 1] = x
+          }
+          med = (m % 2) ? v[(m + 1) / 2] : ((v[m / 2] + v[m / 2 + 1]) / 2)
+          line = key "," med
+        }
+        if (key in tol) { line = line "," tol[key] }
+        print line
+      }
+    }' "$old" "$@" > "$dst"
+}
+
+# Compares baseline $1 with results $2 (see top comment); prints a table; exit code 0 if and only if all is well.
+compare()
+{
+  awk -F, -v dflt_tol="$GATE_TOLERANCE_PCT" '
+    FNR == 1 { next } # Header.
+    NR == FNR { base[$1] = $2; tol[$1] = $3; order[++n] = $1; next }
+    { cur[$1] = $2 }
+    END {
+      bad = 0
+      for (i = 1; i <= n; ++i) {
+        key = order[i]
+        if (key ~ /_usec$/) { lower_better = 1 } else if (key ~ /_per_sec$/) { lower_better = 0 } else { continue }
+        t = tol[key]
+        if (t == "") {
+          if (key !~ /(rtt_p50_usec|one_way_p50_usec|tput_msgs_per_sec)$/) { continue }
+          t = dflt_tol
+        }
+        if (t == "-") { continue }
+        if (!(key in cur)) {
+          printf "%-45s | %12s | %12s | %8s | FAIL (missing)\n", key, base[key], "-", "-"
+          bad = 1
+          continue
+        }
+        b = base[key] + 0
+        c = cur[key] + 0
+        change = (b == 0) ? 0 : (100 * (c - b) / b)
+        worse = lower_better ? change : -change
+        verdict = (worse > t + 0) ? "FAIL" : "ok"
+        if (verdict == "FAIL") { bad = 1 }
+        printf "%-45s | %12.3f | %12.3f | %+7.1f%% | %s (tolerance %s%%)\n", key, b, c, change, verdict, t
+      }
+      exit bad
+    }' "$1" "$2"
+}
+
+status=0
+missing=0
+for variant in "$@"; do
+  baseline="$BASELINE_DIR/$variant.csv"
+  if [ "$RECORD" = 0 ] && [ ! -f "$baseline" ]; then
+    echo "[$variant]: no baseline at [$baseline]; nothing to compare against.  Record one first, on this machine" \
+         "and with a known-good build: \`perf_gate.sh --record\` (e.g., via the perf_demo_gate_record target)." >&2
+    missing=1
+    continue
+  fi
+
+  runs=""
+  run=1
+  while [ "$run" -le "$GATE_RUNS" ]; do
+    echo "[$variant]: run [$run/$GATE_RUNS]..."
+    if ! run_one "$variant" "$run"; then
+      status=1
+      runs=""
+      break
+    fi
+    runs="$runs $OUT_DIR/$variant.$run.csv"
+    run=$((run + 1))
+  done
+  if [ -z "$runs" ]; then
+    continue
+  fi
+
+  if [ "$RECORD" = 1 ]; then
+    old=/dev/null
+    if [ -f "$baseline" ]; then
+      old="$OUT_DIR/$variant.old_baseline.csv"
+      cp "$baseline" "$old"
+    fi
+    # shellcheck disable=SC2086 # We want $runs word-split.
+    combine "$old" "$baseline" $runs
+    echo "[$variant]: recorded the median of [$GATE_RUNS] run(s) as the baseline: [$baseline]."
+    continue
+  fi
+
+  # shellcheck disable=SC2086
+  combine /dev/null "$OUT_DIR/$variant.csv" $runs
+
+  printf '%-45s | %12s | %12s | %8s | %s\n' "[$variant] metric" "baseline" "current" "change" "verdict"
+  if ! compare "$baseline" "$OUT_DIR/$variant.csv"; then
+    status=1
+    echo "[$variant]: REGRESSION (or missing metric) versus [$baseline]."
+  fi
+done
+
+if [ "$status" = 0 ] && [ "$missing" = 1 ]; then
+  exit "$SKIP_EXIT"
+fi
+exit "$status"
@@ -0,0 +1,122 @@
+#!/bin/sh
+
+# Flow-IPC
+# Copyright 2023 Akamai Technologies, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in
+# compliance with the License.  You may obtain a copy
+# of the License at
+#
+#   https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in
+# writing, software distributed under the License is
+# distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+# CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing
+# permissions and limitations under the License.
+
+# Runs every perf_demo srv/cli variant (SHM-provider x MQ type) -- and, where the variant has a choice,
+# each serialization mode (--serialize) -- one after another; then prints a table of the results.
+#
+# Usage (from the installed bin dir, where the perf_demo_*.exec live):
+#   [SRV_ARGS="<extra srv args>"] [CLI_ARGS="<extra cli args>"] ./run_matrix.sh
+# E.g., SRV_ARGS="0.5" CLI_ARGS="--iterations=100" ./run_matrix.sh
+#
+# Requires the full matrix to have been built: configure with -DPERF_DEMO_FULL_MATRIX=ON.  (By default only the
+# shm_classic and shm_jemalloc pairs, sans MQ, are built; the other variants are then skipped.)
+#
+# Note: The heap variants (and more so the heap+MQ ones) cannot transmit large structured messages; keep the
+# size to ~1Mi or less, or those variants will fail (and be reported as such below).  Hence SRV_ARGS, unlike the
+# srv's own default size, defaults to 1Mi.
+#
+# Each variant's full output goes to matrix_results/<variant>/{srv,cli}.out; the benchmark summaries are
+# concatenated into matrix_results/summary.txt.
+
+# Exit immediately if any command has a non-zero exit status.
+set -e
+
+OUT_DIR=matrix_results
+SUMMARY="$OUT_DIR/summary.txt"
+SRV_WAIT_SECS=30
+SRV_ARGS=${SRV_ARGS-1}
+
+rm -rf "$OUT_DIR"
+mkdir -p "$OUT_DIR"
+: > "$SUMMARY"
+
+# Prints the value of the "RTT = [...]" line matching $2 in file $1; or "-" if none (e.g., a multi-size sweep, whose
+# table is in the summary file instead).
+rtt_of()
+{
+  rtt=$(grep -o "$2.*RTT = \[[0-9]* usec\]" "$1" | sed 's/.*RTT = \[\([0-9]*\) usec\]/\1/' | tail -n 1)
+  echo "${rtt:--}"
+}
+
+# Runs 1 srv/cli pair ($1 = exec name suffix, e.g., "shm_classic_mq_posix"; $2 = --serialize value).
+run_one()
+{
+  srv="./perf_demo_srv_$1.exec"
+  cli="./perf_demo_cli_$1.exec"
+  variant="$1.$2"
+  dir="$OUT_DIR/$variant"
+
+  if [ ! -x "$srv" ] || [ ! -x "$cli" ]; then
+    echo "[$variant]: executables not found (built with -DPERF_DEMO_FULL_MATRIX=ON?); skipping."
+    return
+  fi
+
+  mkdir -p "$dir"
+  echo "[$variant]: running..."
+
+  # shellcheck disable=SC2086 # We want SRV_ARGS/CLI_ARGS word-split.
+  "$srv" --serialize="$2" $SRV_ARGS > "$dir/srv.out" 2>&1 &
+  srv_pid=$!
+
+  # Wait until the server is ready for the client (or has died).
+  waited=0
+  while ! grep -q "You can now invoke" "$dir/srv.out"; do
+    if ! kill -0 "$srv_pid" 2> /dev/null || [ "$waited" -ge "$SRV_WAIT_SECS" ]; then
+      break
+    fi
+    sleep 1
+    waited=$((waited + 1))
+  done
+
+  status=ok
+  # shellcheck disable=SC2086
+  if ! "$cli" --serialize="$2" $CLI_ARGS > "$dir/cli.out" 2>&1; then
+    status=FAILED
+  fi
+  if ! wait "$srv_pid"; then
+    status=FAILED
+  fi
+
+  printf '%-40s | %-6s | %12s | %16s\n' "$variant" "$status" \
+         "$(rtt_of "$dir/cli.out" "Via raw-")" "$(rtt_of "$dir/cli.out" "Via-Flow-IPC-structured-channel")" \
+    >> "$OUT_DIR/table.txt"
+
+  {
+    echo "===== [$variant]: $status ====="
+    sed -n '/Benchmark summary/,$p' "$dir/cli.out"
+    echo
+  } >> "$SUMMARY"
+}
+
+: > "$OUT_DIR/table.txt"
+for shm in shm_classic shm_jemalloc heap; do
+  for mq in "" _mq_posix _mq_bipc; do
+    if [ "$shm" = heap ]; then
+      run_one "$shm$mq" heap
+    else
+      run_one "$shm$mq" session-shm
+      run_one "$shm$mq" app-shm
+    fi
+  done
+done
+
+echo
+echo "Results (RTT in usec; single-size runs only -- see [$SUMMARY] for sweeps and more detail):"
+printf '%-40s | %-6s | %12s | %16s\n' "variant" "status" "raw RTT" "Flow-IPC RTT"
+cat "$OUT_DIR/table.txt"